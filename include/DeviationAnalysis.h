@@ -0,0 +1,87 @@
+/**
+ * @file DeviationAnalysis.h
+ * @author DMD team, IU
+ * @brief header file for DeviationAnalysis class
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
+ *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ *                oneTBB - parallel loops over the defect mesh vertices.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <MRMesh/MRMesh.h>
+#include <MRMesh/MRMeshPart.h>
+#include <MRMesh/MRVector.h>
+#include <MRMesh/MRColor.h>
+
+/**
+ * DeviationAnalysis class measures how far the aligned defect mesh is from the ideal mesh.
+ *
+ * For every vertex of the defect mesh the signed distance to the ideal surface is computed
+ * (negative = inside the ideal mesh, i.e. material is missing; positive = excess material).
+ * Distance queries go through the AABB tree cached inside the ideal MR::Mesh, which is the
+ * same tree ICP already built when projecting onto the ideal mesh, so no new tree is built.
+ *
+ * The missing volume is the volume of the ideal mesh minus the defect mesh (DifferenceAB), so
+ * excess material elsewhere on the part does not cancel out the missing material.
+ */
+
+namespace DMD
+{
+    struct DeviationSettings
+    {
+        int histogramBins = 64;               // number of bins in the histogram
+        float histogramRange = 0.f;           // histogram covers [-range, range] mm, 0 = use max |deviation|
+        float maxDeviation = 1.f;             // pass if every |deviation| is below this value (mm)
+        float maxMissingVolume = 100.f;       // pass if the missing volume is below this value (mm^3)
+        float colorRange = 1.f;               // deviation (mm) mapped to full blue / full red
+        std::filesystem::path plyPath;        // colored PLY of the defect mesh, empty = skip
+        std::filesystem::path binaryPath;     // compact binary with per-vertex deviations, empty = skip
+        std::filesystem::path histogramPath;  // CSV histogram, empty = skip
+    };
+
+    struct DeviationReport
+    {
+        MR::VertScalars deviations;           // signed distance per defect vertex (mm)
+        std::vector<size_t> histogram;        // vertex count per bin
+        float histogramMin = 0.f;             // left edge of the first bin (mm)
+        float binWidth = 0.f;                 // width of one bin (mm)
+        float minDeviation = 0.f;
+        float maxDeviation = 0.f;
+        float meanDeviation = 0.f;
+        float rmsDeviation = 0.f;
+        double missingVolume = 0.0;           // volume of ideal minus defect (DifferenceAB) in mm^3, NaN if the boolean failed
+        size_t numVertices = 0;
+        bool passed = false;
+
+        void print(std::ostream &out) const;
+    };
+
+    class DeviationAnalysis
+    {
+    public:
+        explicit DeviationAnalysis(const DeviationSettings &settings = {});
+
+        DeviationReport run(const MR::Mesh &ideal_mesh, const MR::Mesh &defect_mesh) const;
+        // missing_material is the DifferenceAB of ideal and defect, nullptr if it could not be computed
+        DeviationReport run(const MR::Mesh &ideal_mesh, const MR::Mesh &defect_mesh,
+                            const MR::Mesh *missing_material) const;
+
+    private:
+        DeviationSettings settings_;
+
+        MR::VertScalars computeDeviations(const MR::Mesh &ideal_mesh, const MR::Mesh &defect_mesh) const;
+        void computeStatistics(DeviationReport &report) const;
+        void computeHistogram(DeviationReport &report) const;
+        MR::VertColors colorize(const MR::VertScalars &deviations) const;
+        bool saveBinary(const DeviationReport &report) const;
+        bool saveHistogram(const DeviationReport &report) const;
+    };
+
+} // namespace DMD
@@ -0,0 +1,74 @@
+/**
+ * @file JobScheduler.h
+ * @author DMD team, IU
+ * @brief header file for JobScheduler class
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: oneTBB - one task arena per concurrent job.
+ */
+
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * JobScheduler class runs many part jobs in one process, K of them at a time.
+ *
+ * Every concurrent job slot owns a TBB task arena of threadsPerJob threads, so the jobs
+ * share the machine without oversubscribing it (unlike several processes each using the
+ * global TBB scheduler). Slots can be pinned to disjoint cores or bound to NUMA nodes;
+ * with either, memory touched by a job is placed near its threads by the first-touch policy.
+ */
+
+namespace DMD
+{
+    struct JobSchedulerSettings
+    {
+        int jobs = 1;           // number of jobs running at once
+        int threadsPerJob = 0;  // threads in every job arena, 0 = available cores / jobs
+        bool pinThreads = false; // pin the threads of every slot to its own range of cores (Linux)
+        bool numaAware = false;  // bind slots to NUMA nodes round robin (needs TBB with tbbbind)
+    };
+
+    struct Job
+    {
+        std::string name;
+        std::function<int()> run; // returns 0 on success, like Pipeline::run
+    };
+
+    struct JobResult
+    {
+        std::string name;
+        int status = -1;
+        int slot = -1;
+        double seconds = 0.0; // latency of the job
+    };
+
+    struct BatchReport
+    {
+        std::vector<JobResult> results;
+        double wallSeconds = 0.0;
+        int jobs = 0;
+        int threadsPerJob = 0;
+
+        double partsPerHour() const;
+        void print(std::ostream &out) const;
+    };
+
+    class JobScheduler
+    {
+    public:
+        explicit JobScheduler(const JobSchedulerSettings &settings = {});
+
+        BatchReport run(const std::vector<Job> &jobs) const;
+
+        static std::vector<int> availableCores();
+
+    private:
+        JobSchedulerSettings settings_;
+    };
+
+} // namespace DMD
@@ -2,57 +2,168 @@
  * @file Pipeline.h
  * @author DMD team, IU
  * @brief header file for Pipeline class
- * @version 0.1
- * @date 2024-11-09
+ * @version 0.2
+ * @date 2026-10-19
  * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
  *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ *                oneTBB - runs independent branches of the stage graph in parallel.
  */
 
 #pragma once
 
+#include <deque>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <functional>
+#include <map>
 #include <optional>
-#include <MRMesh/MRMesh.h>
-#include <MRMesh/MRMeshLoad.h>
-#include <MRMesh/MRMeshFillHole.h>
-#include <MRVoxels/MRRebuildMesh.h>
-#include <MRMesh/MRMeshPart.h>
-#include <MRMesh/MRMeshSave.h>
-#include <MRMesh/MRBox.h>
-#include <MRMesh/MRICP.h>
-#include <MRMesh/MRMeshBoolean.h>
-#include <MRMesh/MRCube.h>
-#include <MRMesh/MRVector3.h>
+#include <string>
+#include <typeindex>
+#include <variant>
+#include <vector>
+#include "Stages.h"
+#include "DeviationAnalysis.h"
+#include "PointCloudPreprocessing.h"
 
 /**
  * Pipeline class for our meshes processing pipeline.
+ *
+ * The pipeline is a graph of typed stages (load, fill, rebuild, point cloud preprocessing,
+ * ICP, transform, boolean, deviation, save). Adding a stage only records it; nothing runs
+ * until a result is requested. Evaluation computes only the stages the requested results
+ * depend on, runs independent branches in parallel and keeps every intermediate result in memory.
  */
 
 namespace DMD
 {
+    /**
+     * All values which can flow between stages.
+     */
+    using StageValue = std::variant<MR::Mesh, MR::PointCloud, MR::AffineXf3f, DeviationReport>;
+
+    /**
+     * Typed handle of a stage output.
+     */
+    template <typename T>
+    struct Port
+    {
+        size_t node = size_t(-1);
+    };
+
     class Pipeline
     {
     public:
+        using StageInputs = std::vector<const StageValue *>; // nullptr for a failed optional input
+        using StageFunc = std::function<MR::Expected<StageValue>(const StageInputs &)>;
+
         Pipeline(const std::filesystem::path ideal_path, const std::filesystem::path defect_path);
         Pipeline();
         ~Pipeline();
 
+        // typed stages, each returns the port of its output
+        Port<MR::Mesh> loadMesh(const std::filesystem::path &path);
+        Port<MR::PointCloud> loadPoints(const std::filesystem::path &path);
+        Port<MR::PointCloud> preprocessPoints(Port<MR::PointCloud> cloud, const PointCloudSettings &settings);
+        Port<MR::Mesh> fillHoles(Port<MR::Mesh> mesh);
+        Port<MR::Mesh> reBuild(Port<MR::Mesh> mesh, float voxelSize = Stages::defaultVoxelSize);
+        Port<MR::Mesh> reBuildNarrowBand(Port<MR::Mesh> mesh, const NarrowBandSettings &settings = {});
+        Port<MR::AffineXf3f> localICP(Port<MR::Mesh> ideal_mesh, Port<MR::Mesh> defect_mesh, const ICPSettings &settings = {});
+        Port<MR::AffineXf3f> localICP(Port<MR::Mesh> ideal_mesh, Port<MR::PointCloud> defect_cloud, const ICPSettings &settings = {});
+        Port<MR::AffineXf3f> globalICP(Port<MR::Mesh> ideal_mesh, Port<MR::Mesh> defect_mesh, const ICPSettings &settings = {});
+        Port<MR::Mesh> transform(Port<MR::Mesh> mesh, Port<MR::AffineXf3f> xf);
+        Port<MR::PointCloud> transform(Port<MR::PointCloud> cloud, Port<MR::AffineXf3f> xf);
+        Port<MR::Mesh> booleanOperation(Port<MR::Mesh> mesh_a, Port<MR::Mesh> mesh_b,
+                                        MR::BooleanOperation operation = MR::BooleanOperation::DifferenceAB);
+        Port<DeviationReport> deviationAnalysis(Port<MR::Mesh> ideal_mesh, Port<MR::Mesh> defect_mesh,
+                                                const DeviationSettings &settings = {});
+        // reuses the DifferenceAB of ideal and defect already in the graph for the missing volume
+        Port<DeviationReport> deviationAnalysis(Port<MR::Mesh> ideal_mesh, Port<MR::Mesh> defect_mesh,
+                                                Port<MR::Mesh> missing_material, const DeviationSettings &settings = {});
+        Port<MR::Mesh> saveMesh(Port<MR::Mesh> mesh, const std::filesystem::path &path);
+        Port<MR::PointCloud> savePoints(Port<MR::PointCloud> cloud, const std::filesystem::path &path);
+
+        // fill holes, rebuild, local ICP, deviation analysis and DifferenceAB of ideal and defect meshes
+        void addBooleanGraph(const std::filesystem::path &ideal_path, const std::filesystem::path &defect_path,
+                             const std::filesystem::path &output_dir = "../meshes",
+                             float voxelSize = Stages::defaultVoxelSize);
+
+        /**
+         * @brief Adds a custom stage producing a value of type T.
+         *
+         * @param name The stage name used in logs.
+         * @param inputs The nodes whose values are passed to func, in the same order.
+         * @param func Computes the stage value from the input values.
+         * @param required The number of leading inputs the stage needs; if a later (optional) input
+         *        fails, the stage still runs and gets nullptr for it.
+         */
+        template <typename T>
+        Port<T> addStage(std::string name, std::vector<size_t> inputs, StageFunc func, size_t required = size_t(-1))
+        {
+            return Port<T>{addNode(std::move(name), std::type_index(typeid(T)), std::move(inputs), std::move(func), required)};
+        }
+
+        // true if missing_material is the DifferenceAB stage of exactly these ideal and defect nodes
+        bool isDifference(Port<MR::Mesh> missing_material, Port<MR::Mesh> ideal_mesh, Port<MR::Mesh> defect_mesh) const;
+
+        // marks the node as a pipeline output, run() evaluates all outputs
+        void markOutput(size_t node);
+
+        // returns the port of the node if it produces T
+        template <typename T>
+        std::optional<Port<T>> port(size_t node) const
+        {
+            if (node >= nodes_.size() || nodes_[node].type != std::type_index(typeid(T)))
+                return std::nullopt;
+            return Port<T>{node};
+        }
+
+        /**
+         * @brief Returns the value of the port, evaluating the stages it depends on if needed.
+         *
+         * @return const T* The value, or nullptr if a stage failed. It stays valid while the pipeline
+         *         exists, also when more stages are added later.
+         */
+        template <typename T>
+        const T *get(Port<T> port)
+        {
+            if (!evaluate({port.node}))
+                return nullptr;
+            return std::get_if<T>(&*nodes_[port.node].value);
+        }
+
+        bool evaluate(const std::vector<size_t> &targets);
         int run();
 
+        size_t size() const { return nodes_.size(); }
+        const std::string &name(size_t node) const { return nodes_[node].name; }
+
     private:
-        std::filesystem::path ideal_mesh_path;
-        std::filesystem::path defect_mesh_path;
-
-        std::optional<MR::Mesh> loadMesh(const std::filesystem::path &path);
-        void fillAndRebuildMesh(MR::Mesh &mesh);
-        void fillHoles(MR::Mesh &mesh);
-        MR::Expected<MR::Mesh> reBuild(MR::Mesh &mesh);
-        void performLocalICP(MR::Mesh &ideal_mesh, MR::Mesh &defect_mesh);
-        void performBooleanOperation(MR::Mesh &ideal_mesh, MR::Mesh &defect_mesh);
-        void saveMesh(const MR::Mesh &result, const std::string &path);
-        static bool onProgress(float v);
+        struct Node
+        {
+            std::string name;
+            std::type_index type;
+            std::vector<size_t> inputs;
+            size_t required; // inputs[required..] are optional
+            StageFunc func;
+            std::optional<StageValue> value;
+        };
+
+        std::deque<Node> nodes_; // deque: adding stages never moves the values get() points to
+        std::vector<size_t> outputs_;
+        bool valid_ = true; // false once a stage with an unknown input was added
+
+        struct BooleanStage
+        {
+            size_t mesh_a;
+            size_t mesh_b;
+            MR::BooleanOperation operation;
+        };
+        std::map<size_t, BooleanStage> booleans_; // operands of every boolean node
+
+        size_t addNode(std::string name, std::type_index type, std::vector<size_t> inputs, StageFunc func,
+                       size_t required = size_t(-1));
+        bool computeNode(size_t node);
     };
 
-} // namespace DMD
\ No newline at end of file
+} // namespace DMD
@@ -0,0 +1,61 @@
+/**
+ * @file PipelineConfig.h
+ * @author DMD team, IU
+ * @brief header file for PipelineConfig class
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
+ *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Pipeline.h"
+
+/**
+ * PipelineConfig class builds a Pipeline stage graph from text, one stage per line:
+ *
+ *     # comment
+ *     ideal   = load $ideal
+ *     idealR  = rebuild ideal 0.278
+ *     xf      = icp_local idealR defectR
+ *     save aligned "../meshes/out.stl"
+ *
+ * The same lines are accepted from a config file and from the command line.
+ * See README.md for the list of stages and their arguments.
+ */
+
+namespace DMD
+{
+    class PipelineConfig
+    {
+    public:
+        explicit PipelineConfig(Pipeline &pipeline);
+
+        // defines a variable, $name and ${name} are replaced by its value inside any argument
+        void define(const std::string &name, const std::string &value);
+
+        bool parseFile(const std::filesystem::path &path);
+        bool parseLine(const std::string &line, int line_number = 0);
+
+        // cuts the line at the first # outside of double quotes
+        static std::string stripComment(const std::string &line);
+
+    private:
+        Pipeline &pipeline_;
+        std::map<std::string, size_t> names_;
+        std::map<std::string, std::string> variables_;
+
+        std::optional<std::string> expandVariables(const std::string &token, int line_number) const;
+        template <typename T>
+        std::optional<Port<T>> lookup(const std::string &name, int line_number) const;
+        bool producesPoints(const std::string &name) const;
+        bool addStage(const std::string &name, const std::vector<std::string> &args, int line_number);
+    };
+
+} // namespace DMD
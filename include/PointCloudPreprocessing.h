@@ -0,0 +1,81 @@
+/**
+ * @file PointCloudPreprocessing.h
+ * @author DMD team, IU
+ * @brief header file for PointCloudPreprocessing class
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
+ *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ *                oneTBB - every step runs in parallel over the cloud.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <MRMesh/MRPointCloud.h>
+#include <MRMesh/MRBox.h>
+#include <MRMesh/MRVector3.h>
+#include <MRMesh/MRAffineXf3.h>
+
+/**
+ * PointCloudPreprocessing class prepares a raw scan for registration, in this order:
+ * PCA alignment, plane or box cropping, voxel-grid downsampling, statistical outlier
+ * removal and normal estimation. It replaces scripts/cut.py and the Open3D
+ * downsampling/normals of scripts/global_registration_example.py. Each step is optional.
+ * Input normals are kept (averaged per voxel when downsampling).
+ */
+
+namespace DMD
+{
+    enum class CropMode
+    {
+        None,
+        Plane, // keep points with dot(planeNormal, p) <= planeOffset
+        Box    // keep points inside cropBox
+    };
+
+    struct PointCloudSettings
+    {
+        bool pcaAlign = false;                 // rotate principal axes (largest variance first) onto x, y, z around the centroid,
+                                               // x and z point towards the longer tail of the cloud (positive third moment)
+
+        CropMode crop = CropMode::None;
+        MR::Vector3f planeNormal{0.f, 0.f, 1.f};
+        float planeOffset = 0.f;
+        float planeMidpointScale = 0.f;        // > 0: planeOffset = scale * midpoint of the cloud along planeNormal, as in cut.py
+        MR::Box3f cropBox;
+
+        float voxelSize = 0.f;                 // > 0: replace the points of every voxel by their centroid
+
+        int outlierNeighbors = 0;              // > 0: remove points whose mean distance to this many neighbors
+        float outlierStdRatio = 2.f;           //      exceeds the global mean by outlierStdRatio standard deviations
+
+        int normalNeighbors = 0;               // > 0: estimate normals from this many nearest neighbors
+    };
+
+    class PointCloudPreprocessing
+    {
+    public:
+        explicit PointCloudPreprocessing(const PointCloudSettings &settings = {});
+
+        MR::PointCloud run(const MR::PointCloud &cloud) const;
+
+    private:
+        PointCloudSettings settings_;
+
+        // the valid points with their normals, normals are empty if not present
+        struct Points
+        {
+            std::vector<MR::Vector3f> points;
+            std::vector<MR::Vector3f> normals;
+        };
+
+        MR::AffineXf3f pcaAlignment(const std::vector<MR::Vector3f> &points) const;
+        Points crop(const Points &cloud) const;
+        Points voxelDownsample(const Points &cloud) const;
+        Points removeOutliers(const Points &cloud) const;
+        std::vector<MR::Vector3f> estimateNormals(const std::vector<MR::Vector3f> &points) const;
+    };
+
+} // namespace DMD
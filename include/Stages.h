@@ -0,0 +1,81 @@
+/**
+ * @file Stages.h
+ * @author DMD team, IU
+ * @brief header file for the mesh processing stages shared by all pipelines
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
+ *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ */
+
+#pragma once
+
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <MRMesh/MRMesh.h>
+#include <MRMesh/MRMeshLoad.h>
+#include <MRMesh/MRMeshFillHole.h>
+#include <MRVoxels/MRRebuildMesh.h>
+#include <MRVoxels/MRVDBConversions.h>
+#include <MRMesh/MRMeshPart.h>
+#include <MRMesh/MRMeshSave.h>
+#include <MRMesh/MRBox.h>
+#include <MRMesh/MRICP.h>
+#include <MRMesh/MRMultiwayICP.h>
+#include <MRMesh/MRMeshBoolean.h>
+#include <MRMesh/MRVector3.h>
+#include <MRMesh/MRAffineXf3.h>
+#include <MRMesh/MRPointCloud.h>
+#include <MRMesh/MRPointsLoad.h>
+#include <MRMesh/MRPointsSave.h>
+
+/**
+ * Stateless building blocks of our meshes processing pipelines.
+ * Each function does one step and is wrapped into a typed stage by DMD::Pipeline.
+ */
+
+namespace DMD
+{
+    /**
+     * ICP parameters, relative to the bounding box diagonal of the reference mesh.
+     */
+    struct ICPSettings
+    {
+        float samplingFactor = 0.01f;      // sampling voxel size = diagonal * samplingFactor
+        float distThresholdFactor = 0.1f;  // max distance of point pairs = diagonal * distThresholdFactor
+        float exitFactor = 0.003f;         // stop when distance reached = diagonal * exitFactor
+        int iterLimit = 10;                // maximum number of ICP iterations
+    };
+
+    /**
+     * Narrow band rebuild parameters. Only voxels within bandWidth of the surface are stored
+     * (sparse OpenVDB grid), so memory and time grow with the surface area, not the volume.
+     */
+    struct NarrowBandSettings
+    {
+        float voxelSize = 0.278f; // in mm
+        float bandWidth = 3.f;    // half width of the band in voxels
+        float adaptivity = 0.f;   // 0 = uniform triangles, up to 1 = merge voxels in flat regions, keep detail where curved
+    };
+
+    namespace Stages
+    {
+        constexpr float defaultVoxelSize = 0.278f; // in mm
+
+        MR::Expected<MR::Mesh> loadMesh(const std::filesystem::path &path);
+        MR::Expected<MR::PointCloud> loadPoints(const std::filesystem::path &path);
+        void fillHoles(MR::Mesh &mesh);
+        MR::Expected<MR::Mesh> reBuild(const MR::Mesh &mesh, float voxelSize = defaultVoxelSize);
+        MR::Expected<MR::Mesh> reBuildNarrowBand(const MR::Mesh &mesh, const NarrowBandSettings &settings = {});
+        MR::AffineXf3f localICP(const MR::Mesh &ideal_mesh, const MR::MeshOrPoints &defect, const ICPSettings &settings = {});
+        MR::AffineXf3f globalICP(const MR::Mesh &ideal_mesh, const MR::Mesh &defect_mesh, const ICPSettings &settings = {});
+        MR::Expected<MR::Mesh> booleanOperation(const MR::Mesh &mesh_a, const MR::Mesh &mesh_b, MR::BooleanOperation operation);
+        void transformPoints(MR::PointCloud &cloud, const MR::AffineXf3f &xf);
+        MR::Expected<void> saveMesh(const MR::Mesh &mesh, const std::filesystem::path &path);
+        MR::Expected<void> savePoints(const MR::PointCloud &cloud, const std::filesystem::path &path);
+        std::string affineToString(const MR::AffineXf3f &transform);
+        bool onProgress(float v);
+    } // namespace Stages
+
+} // namespace DMD
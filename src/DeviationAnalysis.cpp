@@ -0,0 +1,320 @@
+/**
+ * @file DeviationAnalysis.cpp
+ * @author DMD team, IU
+ * @brief Implementation of DeviationAnalysis class
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
+ *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ *                oneTBB - parallel loops over the defect mesh vertices.
+ */
+
+#include "DeviationAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <MRMesh/MRMeshBoolean.h>
+#include <MRMesh/MRMeshProject.h>
+#include <MRMesh/MRMeshSave.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/enumerable_thread_specific.h>
+
+namespace DMD
+{
+
+    /**
+     * @brief Prints the summary of the deviation report.
+     *
+     * @param out The stream to print to.
+     */
+    void DeviationReport::print(std::ostream &out) const
+    {
+        out << "Deviation analysis of " << numVertices << " vertices:" << std::endl;
+        out << "  min: " << minDeviation << " mm, max: " << maxDeviation << " mm" << std::endl;
+        out << "  mean: " << meanDeviation << " mm, rms: " << rmsDeviation << " mm" << std::endl;
+        if (std::isnan(missingVolume))
+            out << "  missing volume: n/a" << std::endl;
+        else
+            out << "  missing volume: " << missingVolume << " mm^3" << std::endl;
+        out << "  result: " << (passed ? "PASS" : "FAIL") << std::endl;
+    }
+
+    /**
+     * @brief Constructor for DeviationAnalysis class
+     *
+     * @param settings Histogram, pass/fail thresholds and output paths.
+     */
+    DeviationAnalysis::DeviationAnalysis(const DeviationSettings &settings)
+        : settings_(settings) {}
+
+    /**
+     * @brief Runs the deviation analysis, computing the missing material (ideal minus defect) first.
+     *
+     * @param ideal_mesh Reference to the ideal mesh.
+     * @param defect_mesh Reference to the aligned defect mesh.
+     * @return DeviationReport Per-vertex deviations, statistics, histogram and pass/fail result.
+     */
+    DeviationReport DeviationAnalysis::run(const MR::Mesh &ideal_mesh, const MR::Mesh &defect_mesh) const
+    {
+        MR::BooleanResult difference = MR::boolean(ideal_mesh, defect_mesh, MR::BooleanOperation::DifferenceAB);
+        if (!difference.valid())
+        {
+            std::cerr << "Error computing the missing volume: " << difference.errorString << std::endl;
+            return run(ideal_mesh, defect_mesh, nullptr);
+        }
+        return run(ideal_mesh, defect_mesh, &difference.mesh);
+    }
+
+    /**
+     * @brief Runs the deviation analysis of the aligned defect mesh against the ideal mesh.
+     *
+     * The defect mesh must already be transformed into the ideal mesh coordinates (after ICP).
+     *
+     * @param ideal_mesh Reference to the ideal mesh.
+     * @param defect_mesh Reference to the aligned defect mesh.
+     * @param missing_material The ideal mesh minus the defect mesh (DifferenceAB), nullptr if that boolean
+     *                         failed; the missing volume is then NaN and the part fails.
+     * @return DeviationReport Per-vertex deviations, statistics, histogram and pass/fail result.
+     */
+    DeviationReport DeviationAnalysis::run(const MR::Mesh &ideal_mesh, const MR::Mesh &defect_mesh,
+                                           const MR::Mesh *missing_material) const
+    {
+        DeviationReport report;
+        report.deviations = computeDeviations(ideal_mesh, defect_mesh);
+        computeStatistics(report);
+        computeHistogram(report);
+
+        // the volume of ideal minus defect, not the difference of both volumes, so a bump of
+        // excess material does not hide a dent of the same size
+        report.missingVolume = missing_material ? std::max(0.0, missing_material->volume())
+                                                : std::numeric_limits<double>::quiet_NaN();
+        // a NaN missing volume (failed boolean) never passes
+        report.passed = std::max(std::abs(report.minDeviation), std::abs(report.maxDeviation)) <= settings_.maxDeviation &&
+                        report.missingVolume <= settings_.maxMissingVolume;
+
+        if (!settings_.plyPath.empty())
+        {
+            MR::VertColors colors = colorize(report.deviations);
+            MR::SaveSettings saveSettings;
+            saveSettings.colors = &colors;
+            if (auto res = MR::MeshSave::toAnySupportedFormat(defect_mesh, settings_.plyPath, saveSettings); !res)
+                std::cerr << "Error saving deviation map to " << settings_.plyPath << ": " << res.error() << std::endl;
+            else
+                std::cout << "Saved the deviation map to " << settings_.plyPath << std::endl;
+        }
+        if (!settings_.binaryPath.empty() && saveBinary(report))
+            std::cout << "Saved the deviations to " << settings_.binaryPath << std::endl;
+        if (!settings_.histogramPath.empty() && saveHistogram(report))
+            std::cout << "Saved the histogram to " << settings_.histogramPath << std::endl;
+
+        return report;
+    }
+
+    /**
+     * @brief Computes the signed distance from every defect vertex to the ideal surface in parallel.
+     *
+     * @param ideal_mesh Reference to the ideal mesh, its cached AABB tree is reused.
+     * @param defect_mesh Reference to the aligned defect mesh.
+     * @return MR::VertScalars Signed distances, NaN for invalid vertices.
+     */
+    MR::VertScalars DeviationAnalysis::computeDeviations(const MR::Mesh &ideal_mesh, const MR::Mesh &defect_mesh) const
+    {
+        const auto &validVerts = defect_mesh.topology.getValidVerts();
+        MR::VertScalars deviations(defect_mesh.topology.vertSize(), std::numeric_limits<float>::quiet_NaN());
+
+        // build (or fetch the cached) tree once before the parallel loop, not lazily inside it
+        ideal_mesh.getAABBTree();
+        MR::MeshPart idealPart(ideal_mesh);
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, deviations.size()),
+                          [&](const tbb::blocked_range<size_t> &range)
+                          {
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                              {
+                                  MR::VertId v(i);
+                                  if (!validVerts.test(v))
+                                      continue;
+                                  if (auto sd = MR::findSignedDistance(defect_mesh.points[v], idealPart))
+                                      deviations[v] = sd->dist;
+                              }
+                          });
+        return deviations;
+    }
+
+    /**
+     * @brief Computes min, max, mean and rms of the deviations with a parallel reduction.
+     *
+     * @param report The report to fill in.
+     */
+    void DeviationAnalysis::computeStatistics(DeviationReport &report) const
+    {
+        struct Accum
+        {
+            float min = std::numeric_limits<float>::max();
+            float max = std::numeric_limits<float>::lowest();
+            double sum = 0.0;
+            double sumSq = 0.0;
+            size_t count = 0;
+        };
+
+        const auto &deviations = report.deviations;
+        Accum total = tbb::parallel_reduce(
+            tbb::blocked_range<size_t>(0, deviations.size()), Accum{},
+            [&](const tbb::blocked_range<size_t> &range, Accum acc)
+            {
+                for (size_t i = range.begin(); i < range.end(); ++i)
+                {
+                    float d = deviations[MR::VertId(i)];
+                    if (std::isnan(d))
+                        continue;
+                    acc.min = std::min(acc.min, d);
+                    acc.max = std::max(acc.max, d);
+                    acc.sum += d;
+                    acc.sumSq += double(d) * d;
+                    ++acc.count;
+                }
+                return acc;
+            },
+            [](Accum a, const Accum &b)
+            {
+                a.min = std::min(a.min, b.min);
+                a.max = std::max(a.max, b.max);
+                a.sum += b.sum;
+                a.sumSq += b.sumSq;
+                a.count += b.count;
+                return a;
+            });
+
+        report.numVertices = total.count;
+        if (total.count == 0)
+            return;
+        report.minDeviation = total.min;
+        report.maxDeviation = total.max;
+        report.meanDeviation = static_cast<float>(total.sum / total.count);
+        report.rmsDeviation = static_cast<float>(std::sqrt(total.sumSq / total.count));
+    }
+
+    /**
+     * @brief Builds the deviation histogram using thread local bins merged at the end.
+     *
+     * @param report The report to fill in, statistics must be computed already.
+     */
+    void DeviationAnalysis::computeHistogram(DeviationReport &report) const
+    {
+        const int bins = std::max(1, settings_.histogramBins);
+        float range = settings_.histogramRange;
+        if (range <= 0.f)
+            range = std::max(std::abs(report.minDeviation), std::abs(report.maxDeviation));
+        if (range <= 0.f)
+            range = 1.f;
+
+        report.histogramMin = -range;
+        report.binWidth = 2.f * range / bins;
+        report.histogram.assign(bins, 0);
+
+        const auto &deviations = report.deviations;
+        tbb::enumerable_thread_specific<std::vector<size_t>> localHistograms(std::vector<size_t>(bins, 0));
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, deviations.size()),
+                          [&](const tbb::blocked_range<size_t> &r)
+                          {
+                              auto &local = localHistograms.local();
+                              for (size_t i = r.begin(); i < r.end(); ++i)
+                              {
+                                  float d = deviations[MR::VertId(i)];
+                                  if (std::isnan(d))
+                                      continue;
+                                  int bin = static_cast<int>((d - report.histogramMin) / report.binWidth);
+                                  ++local[std::clamp(bin, 0, bins - 1)];
+                              }
+                          });
+
+        for (const auto &local : localHistograms)
+            for (int i = 0; i < bins; ++i)
+                report.histogram[i] += local[i];
+    }
+
+    /**
+     * @brief Maps the deviations to vertex colors: blue = missing material, green = on surface, red = excess.
+     *
+     * @param deviations Signed distances per vertex.
+     * @return MR::VertColors The color of every vertex.
+     */
+    MR::VertColors DeviationAnalysis::colorize(const MR::VertScalars &deviations) const
+    {
+        MR::VertColors colors(deviations.size(), MR::Color::gray());
+        const float colorRange = settings_.colorRange > 0.f ? settings_.colorRange : 1.f;
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, deviations.size()),
+                          [&](const tbb::blocked_range<size_t> &range)
+                          {
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                              {
+                                  MR::VertId v(i);
+                                  float d = deviations[v];
+                                  if (std::isnan(d))
+                                      continue;
+                                  float t = std::clamp(d / colorRange, -1.f, 1.f);
+                                  int hot = static_cast<int>(255.f * std::abs(t));
+                                  if (t < 0.f)
+                                      colors[v] = MR::Color(0, 255 - hot, hot);
+                                  else
+                                      colors[v] = MR::Color(hot, 255 - hot, 0);
+                              }
+                          });
+        return colors;
+    }
+
+    /**
+     * @brief Saves the deviations to a compact binary file.
+     *
+     * Layout: 8 bytes magic "DMDDEV01", uint64 vertex count, then one float32 per vertex
+     * (NaN for invalid vertices), in the vertex order of the defect mesh.
+     *
+     * @param report The report with computed deviations.
+     * @return true if the file was written, false otherwise.
+     */
+    bool DeviationAnalysis::saveBinary(const DeviationReport &report) const
+    {
+        std::ofstream out(settings_.binaryPath, std::ios::binary);
+        if (!out)
+        {
+            std::cerr << "Error opening " << settings_.binaryPath << std::endl;
+            return false;
+        }
+        const char magic[8] = {'D', 'M', 'D', 'D', 'E', 'V', '0', '1'};
+        const std::uint64_t count = report.deviations.size();
+        out.write(magic, sizeof(magic));
+        out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char *>(report.deviations.data()), count * sizeof(float));
+        return bool(out);
+    }
+
+    /**
+     * @brief Saves the histogram as CSV with columns bin_start, bin_end, count.
+     *
+     * @param report The report with computed histogram.
+     * @return true if the file was written, false otherwise.
+     */
+    bool DeviationAnalysis::saveHistogram(const DeviationReport &report) const
+    {
+        std::ofstream out(settings_.histogramPath);
+        if (!out)
+        {
+            std::cerr << "Error opening " << settings_.histogramPath << std::endl;
+            return false;
+        }
+        out << "bin_start,bin_end,count\n";
+        for (size_t i = 0; i < report.histogram.size(); ++i)
+        {
+            float start = report.histogramMin + i * report.binWidth;
+            out << start << "," << start + report.binWidth << "," << report.histogram[i] << "\n";
+        }
+        return bool(out);
+    }
+
+} // namespace DMD
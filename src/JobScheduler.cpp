@@ -0,0 +1,248 @@
+/**
+ * @file JobScheduler.cpp
+ * @author DMD team, IU
+ * @brief Implementation of JobScheduler class
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: oneTBB - one task arena per concurrent job.
+ */
+
+#include "JobScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tbb/info.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace DMD
+{
+
+    namespace
+    {
+        /**
+         * Pins every thread entering the arena to the given cores.
+         */
+        class PinningObserver : public tbb::task_scheduler_observer
+        {
+        public:
+            PinningObserver(tbb::task_arena &arena, std::vector<int> cores)
+                : tbb::task_scheduler_observer(arena), cores_(std::move(cores))
+            {
+                observe(true);
+            }
+
+            ~PinningObserver() override
+            {
+                observe(false);
+            }
+
+            void on_scheduler_entry(bool) override
+            {
+#ifdef __linux__
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (int core : cores_)
+                    CPU_SET(core, &set);
+                pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+            }
+
+        private:
+            std::vector<int> cores_;
+        };
+
+        /**
+         * One concurrent job slot: its arena and the optional pinning observer.
+         */
+        struct Slot
+        {
+            std::unique_ptr<tbb::task_arena> arena;
+            std::unique_ptr<PinningObserver> observer;
+        };
+    } // namespace
+
+    /**
+     * @brief Throughput of the batch.
+     *
+     * @return double Successfully processed parts per hour of wall time.
+     */
+    double BatchReport::partsPerHour() const
+    {
+        if (wallSeconds <= 0.0)
+            return 0.0;
+        auto done = std::count_if(results.begin(), results.end(), [](const JobResult &r)
+                                  { return r.status == 0; });
+        return done * 3600.0 / wallSeconds;
+    }
+
+    /**
+     * @brief Prints per-job latency and the batch summary.
+     *
+     * @param out The stream to print to.
+     */
+    void BatchReport::print(std::ostream &out) const
+    {
+        out << "\nJob               slot   status   latency" << std::endl;
+        std::vector<double> latencies;
+        for (const auto &r : results)
+        {
+            out << std::left << std::setw(18) << r.name << std::right << std::setw(4) << r.slot
+                << std::setw(9) << (r.status == 0 ? "ok" : "failed")
+                << std::setw(9) << std::fixed << std::setprecision(2) << r.seconds << " s" << std::endl;
+            latencies.push_back(r.seconds);
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        out << jobs << " jobs x " << threadsPerJob << " threads: " << results.size() << " parts in "
+            << std::fixed << std::setprecision(2) << wallSeconds << " s";
+        if (!latencies.empty())
+        {
+            out << ", latency min " << latencies.front() << " s / median " << latencies[latencies.size() / 2]
+                << " s / max " << latencies.back() << " s";
+        }
+        out << ", " << std::setprecision(1) << partsPerHour() << " parts/hour" << std::endl;
+    }
+
+    /**
+     * @brief Constructor for JobScheduler class
+     *
+     * @param settings Number of concurrent jobs, threads per job, pinning and NUMA placement.
+     */
+    JobScheduler::JobScheduler(const JobSchedulerSettings &settings)
+        : settings_(settings) {}
+
+    /**
+     * @brief Lists the cores this process may run on.
+     *
+     * @return std::vector<int> Core ids, 0..n-1 if the affinity mask is not available.
+     */
+    std::vector<int> JobScheduler::availableCores()
+    {
+        std::vector<int> cores;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int core = 0; core < CPU_SETSIZE; ++core)
+                if (CPU_ISSET(core, &set))
+                    cores.push_back(core);
+        }
+#endif
+        if (cores.empty())
+        {
+            for (unsigned core = 0; core < std::max(1u, std::thread::hardware_concurrency()); ++core)
+                cores.push_back(int(core));
+        }
+        return cores;
+    }
+
+    /**
+     * @brief Runs all jobs, at most settings.jobs at a time, each inside its slot's arena.
+     *
+     * @param jobs The jobs, started in the given order.
+     * @return BatchReport Per-job latency and the total wall time.
+     */
+    BatchReport JobScheduler::run(const std::vector<Job> &jobs) const
+    {
+        const std::vector<int> cores = availableCores();
+        const int slotCount = std::max(1, settings_.jobs);
+        const int threads = settings_.threadsPerJob > 0 ? settings_.threadsPerJob
+                                                        : std::max(1, int(cores.size()) / slotCount);
+
+        std::vector<tbb::numa_node_id> numaNodes;
+        if (settings_.numaAware)
+        {
+            numaNodes = tbb::info::numa_nodes();
+            if (numaNodes.size() < 2)
+                std::cout << "Only one NUMA node is visible to TBB, NUMA placement is not used" << std::endl;
+        }
+
+        std::vector<Slot> slots(slotCount);
+        for (int s = 0; s < slotCount; ++s)
+        {
+            tbb::task_arena::constraints constraints;
+            constraints.max_concurrency = threads;
+            if (numaNodes.size() > 1)
+                constraints.numa_id = numaNodes[s % numaNodes.size()];
+            slots[s].arena = std::make_unique<tbb::task_arena>(constraints);
+            slots[s].arena->initialize();
+
+            if (settings_.pinThreads)
+            {
+                // consecutive, disjoint core ranges; wraps around if jobs * threads exceeds the cores
+                std::vector<int> slotCores;
+                for (int t = 0; t < threads; ++t)
+                    slotCores.push_back(cores[(size_t(s) * threads + t) % cores.size()]);
+                slots[s].observer = std::make_unique<PinningObserver>(*slots[s].arena, std::move(slotCores));
+            }
+        }
+
+        BatchReport report;
+        report.jobs = slotCount;
+        report.threadsPerJob = threads;
+        report.results.resize(jobs.size());
+
+        std::atomic<size_t> next = 0;
+        std::mutex logMutex;
+        auto batchStart = std::chrono::steady_clock::now();
+
+        // one driver thread per slot takes the next job and runs it inside the slot's arena
+        std::vector<std::thread> drivers;
+        for (int s = 0; s < slotCount; ++s)
+        {
+            drivers.emplace_back([&, s]
+                                 {
+                                     for (size_t i = next++; i < jobs.size(); i = next++)
+                                     {
+                                         JobResult &result = report.results[i];
+                                         result.name = jobs[i].name;
+                                         result.slot = s;
+                                         auto start = std::chrono::steady_clock::now();
+                                         // an exception must not leave the driver thread, it would terminate the batch
+                                         try
+                                         {
+                                             slots[s].arena->execute([&]
+                                                                     { result.status = jobs[i].run(); });
+                                         }
+                                         catch (const std::exception &e)
+                                         {
+                                             result.status = -1;
+                                             std::lock_guard lock(logMutex);
+                                             std::cerr << "\nJob " << result.name << " failed: " << e.what() << std::endl;
+                                         }
+                                         catch (...)
+                                         {
+                                             result.status = -1;
+                                             std::lock_guard lock(logMutex);
+                                             std::cerr << "\nJob " << result.name << " failed with an unknown exception" << std::endl;
+                                         }
+                                         std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                                         result.seconds = elapsed.count();
+
+                                         std::lock_guard lock(logMutex);
+                                         std::cout << "\nJob " << result.name << " finished on slot " << s << " in "
+                                                   << result.seconds << " s" << std::endl;
+                                     } });
+        }
+        for (auto &driver : drivers)
+            driver.join();
+
+        std::chrono::duration<double> wall = std::chrono::steady_clock::now() - batchStart;
+        report.wallSeconds = wall.count();
+        return report;
+    }
+
+} // namespace DMD
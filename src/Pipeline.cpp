@@ -2,219 +2,597 @@
  * @file Pipeline.cpp
  * @author DMD team, IU
  * @brief Implementation of Pipeline class
- * @version 0.1
- * @date 2024-11-09
+ * @version 0.2
+ * @date 2026-10-19
  * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
  *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ *                oneTBB - runs independent branches of the stage graph in parallel.
  */
 
 #include "Pipeline.h"
 
-/**
- * @brief Constructor for Pipeline class
- *
- * @param ideal_path the path to true mesh
- * @param defect_path the path to defective/deformed mesh
- */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <tbb/task_group.h>
 
 namespace DMD
 {
 
+    /**
+     * @brief Constructor for Pipeline class, builds the default boolean graph
+     *
+     * @param ideal_path the path to true mesh
+     * @param defect_path the path to defective/deformed mesh
+     */
     Pipeline::Pipeline(const std::filesystem::path ideal_path, const std::filesystem::path defect_path)
-        : ideal_mesh_path(ideal_path), defect_mesh_path(defect_path) {}
-
-    Pipeline::Pipeline()
     {
-        std::cout << "No paths provided for ideal and defect meshes. Using default paths"
-                  << std::endl;
-
-        ideal_mesh_path = "../meshes/cylinder_matrix_ideal.stl";
-        defect_mesh_path = "../meshes/cylinder_matrix_defect.stl";
+        addBooleanGraph(ideal_path, defect_path);
     }
 
+    /**
+     * @brief Constructor for an empty Pipeline, stages are added by the caller
+     */
+    Pipeline::Pipeline() = default;
+
     /**
      * @brief Destroy the Pipeline:: Pipeline object
      */
     Pipeline::~Pipeline() = default;
 
     /**
-     * @brief Executes the mesh processing pipeline.
+     * @brief Adds the stages of our main pipeline.
+     *
+     * Fills holes in both meshes and rebuilds them (both branches run in parallel), performs
+     * local Iterative Closest Point (ICP) alignment, measures the deviation of the aligned
+     * defect mesh, saves the repaired and transformed meshes, performs boolean and saves the output.
      *
-     * This function loads the ideal and defective meshes, fills holes in both meshes,
-     * rebuilds them, performs local Iterative Closest Point (ICP) alignment, saves
-     * the repaired and transformed meshes, performs boolean and saves the output
+     * @param ideal_path the path to true mesh
+     * @param defect_path the path to defective/deformed mesh
+     * @param output_dir the folder for the result files
+     * @param voxelSize the rebuild voxel size in mm
      */
-    int Pipeline::run()
+    void Pipeline::addBooleanGraph(const std::filesystem::path &ideal_path, const std::filesystem::path &defect_path,
+                                   const std::filesystem::path &output_dir, float voxelSize)
     {
-        // read the ideal mesh and the defect mesh
-        auto ideal_mesh = loadMesh(ideal_mesh_path);
-        auto defect_mesh = loadMesh(defect_mesh_path);
+        auto ideal = reBuild(fillHoles(loadMesh(ideal_path)), voxelSize);
+        auto defect = reBuild(fillHoles(loadMesh(defect_path)), voxelSize);
+        auto aligned = transform(defect, localICP(ideal, defect));
 
-        // apply our pipeline to these meshes
-        if (ideal_mesh && defect_mesh)
-        {
-            fillAndRebuildMesh(*ideal_mesh);
-            fillAndRebuildMesh(*defect_mesh);
-            performLocalICP(*ideal_mesh, *defect_mesh);
+        auto missing = booleanOperation(ideal, aligned);
 
-            // save rebuild and transformed meshes
-            std::cout << "Saving the repaired meshes..." << std::endl;
-            MR::MeshSave::toAnySupportedFormat(*ideal_mesh, "../meshes/fillHoles_reBuild_ideal_mesh.stl");
-            MR::MeshSave::toAnySupportedFormat(*defect_mesh, "../meshes/fillHoles_reBuild_defect_icp_mesh.stl");
+        DeviationSettings deviationSettings;
+        deviationSettings.plyPath = output_dir / "deviation_defect.ply";
+        deviationSettings.binaryPath = output_dir / "deviation_defect.bin";
+        deviationSettings.histogramPath = output_dir / "deviation_histogram.csv";
+        deviationAnalysis(ideal, aligned, missing, deviationSettings);
 
-            performBooleanOperation(*ideal_mesh, *defect_mesh);
+        // save rebuild and transformed meshes
+        saveMesh(ideal, output_dir / "fillHoles_reBuild_ideal_mesh.stl");
+        saveMesh(aligned, output_dir / "fillHoles_reBuild_defect_icp_mesh.stl");
 
-            return 0;
-        }
-        else
-        {
-            return -1;
-        }
+        saveMesh(missing, output_dir / "out_boolean.stl");
     }
 
     /**
-     * @brief Loads a mesh from a given file path.
+     * @brief Adds a stage loading a mesh from a given file path.
      *
      * @param path The file path to the STL mesh file.
-     * @return std::optional<MR::Mesh> An optional containing the loaded mesh if successful, or empty if failed.
+     * @return Port<MR::Mesh> The loaded mesh.
      */
-    std::optional<MR::Mesh> Pipeline::loadMesh(const std::filesystem::path &path)
+    Port<MR::Mesh> Pipeline::loadMesh(const std::filesystem::path &path)
     {
-        auto mesh = MR::MeshLoad::fromAnyStl(path);
-        if (!mesh)
-        {
-            std::cerr << "Error loading mesh from " << path << std::endl;
-            return std::nullopt;
-        }
-        return *mesh;
+        return addStage<MR::Mesh>("load " + path.filename().string(), {},
+                                  [path](const StageInputs &) -> MR::Expected<StageValue>
+                                  {
+                                      auto mesh = Stages::loadMesh(path);
+                                      if (!mesh)
+                                          return MR::unexpected(mesh.error());
+                                      return std::move(*mesh);
+                                  });
     }
 
     /**
-     * @brief Fills holes in the given mesh and rebuilds it.
+     * @brief Adds a stage loading a point cloud from a given file path.
      *
-     * @param mesh Reference to the mesh to be filled and rebuilt.
+     * @param path The file path to the point cloud.
+     * @return Port<MR::PointCloud> The loaded cloud.
      */
-    void Pipeline::fillAndRebuildMesh(MR::Mesh &mesh)
+    Port<MR::PointCloud> Pipeline::loadPoints(const std::filesystem::path &path)
     {
-        std::cout << "\nFilling holes in mesh..." << std::endl;
-        fillHoles(mesh);
-        std::cout << "Rebuilding mesh..." << std::endl;
-        auto rebuilt_mesh = reBuild(mesh);
-        if (!rebuilt_mesh)
-        {
-            std::cerr << "Error: cannot rebuild the mesh" << std::endl;
-        }
-        mesh = *rebuilt_mesh;
+        return addStage<MR::PointCloud>("load " + path.filename().string(), {},
+                                        [path](const StageInputs &) -> MR::Expected<StageValue>
+                                        {
+                                            auto cloud = Stages::loadPoints(path);
+                                            if (!cloud)
+                                                return MR::unexpected(cloud.error());
+                                            return std::move(*cloud);
+                                        });
     }
 
     /**
-     * @brief Fills holes in the given mesh.
+     * @brief Adds a stage preprocessing a scanned point cloud (align, crop, downsample, outliers, normals).
      *
-     * @param mesh Reference to the mesh in which holes will be filled.
+     * @param cloud The input cloud.
+     * @param settings Which preprocessing steps to run.
+     * @return Port<MR::PointCloud> The preprocessed cloud.
      */
-    void Pipeline::fillHoles(MR::Mesh &mesh)
+    Port<MR::PointCloud> Pipeline::preprocessPoints(Port<MR::PointCloud> cloud, const PointCloudSettings &settings)
     {
-        auto holeEdges = mesh.topology.findHoleRepresentiveEdges();
-        for (MR::EdgeId e : holeEdges)
-        {
-            MR::FillHoleParams params;
-            params.metric = MR::getUniversalMetric(mesh);
-            MR::fillHole(mesh, e, params);
-        }
+        return addStage<MR::PointCloud>("preprocess points", {cloud.node},
+                                        [settings](const StageInputs &in) -> MR::Expected<StageValue>
+                                        {
+                                            PointCloudPreprocessing preprocessing(settings);
+                                            return preprocessing.run(std::get<MR::PointCloud>(*in[0]));
+                                        });
     }
 
     /**
-     * @brief Rebuilds the given mesh.
+     * @brief Adds a stage filling holes in the mesh.
      *
-     * @param mesh Reference to the mesh to be rebuilt.
-     * @return MR::Expected<MR::Mesh> The rebuilt mesh or an error if the process fails.
+     * @param mesh The input mesh.
+     * @return Port<MR::Mesh> The mesh without holes.
      */
-    MR::Expected<MR::Mesh> Pipeline::reBuild(MR::Mesh &mesh)
+    Port<MR::Mesh> Pipeline::fillHoles(Port<MR::Mesh> mesh)
     {
-        // rebuildMesh params setting
-        MR::RebuildMeshSettings settings;
-        settings.decimate = false;
-        settings.voxelSize = 0.278;     // in mm
-        settings.progress = onProgress; // callback for progress
+        return addStage<MR::Mesh>("fill holes", {mesh.node},
+                                  [](const StageInputs &in) -> MR::Expected<StageValue>
+                                  {
+                                      MR::Mesh result = std::get<MR::Mesh>(*in[0]);
+                                      Stages::fillHoles(result);
+                                      return result;
+                                  });
+    }
 
-        MR::MeshPart meshPart(mesh);
-        return MR::rebuildMesh(meshPart, settings);
+    /**
+     * @brief Adds a stage rebuilding the mesh.
+     *
+     * @param mesh The input mesh.
+     * @param voxelSize The voxel size in mm.
+     * @return Port<MR::Mesh> The rebuilt mesh.
+     */
+    Port<MR::Mesh> Pipeline::reBuild(Port<MR::Mesh> mesh, float voxelSize)
+    {
+        return addStage<MR::Mesh>("rebuild", {mesh.node},
+                                  [voxelSize](const StageInputs &in) -> MR::Expected<StageValue>
+                                  {
+                                      auto rebuilt = Stages::reBuild(std::get<MR::Mesh>(*in[0]), voxelSize);
+                                      if (!rebuilt)
+                                          return MR::unexpected("cannot rebuild the mesh: " + rebuilt.error());
+                                      return std::move(*rebuilt);
+                                  });
     }
 
     /**
-     * @brief Performs local ICP alignment between the ideal and defect meshes.
+     * @brief Adds a stage rebuilding the mesh from a sparse narrow band around its surface.
      *
-     * @param ideal_mesh Reference to the ideal mesh.
-     * @param defect_mesh Reference to the defect mesh to be aligned.
+     * @param mesh The input mesh, must be closed (e.g. after fillHoles).
+     * @param settings Voxel size, band width and adaptivity.
+     * @return Port<MR::Mesh> The rebuilt mesh.
      */
-    void Pipeline::performLocalICP(MR::Mesh &ideal_mesh, MR::Mesh &defect_mesh)
+    Port<MR::Mesh> Pipeline::reBuildNarrowBand(Port<MR::Mesh> mesh, const NarrowBandSettings &settings)
     {
-        // following ICP is adapted from examples/mesh_ICP.cpp
-        std::cout << "\nPerforming local ICP..." << std::endl;
+        return addStage<MR::Mesh>("rebuild narrow band", {mesh.node},
+                                  [settings](const StageInputs &in) -> MR::Expected<StageValue>
+                                  {
+                                      auto rebuilt = Stages::reBuildNarrowBand(std::get<MR::Mesh>(*in[0]), settings);
+                                      if (!rebuilt)
+                                          return MR::unexpected("cannot rebuild the mesh: " + rebuilt.error());
+                                      return std::move(*rebuilt);
+                                  });
+    }
 
-        // Prepare ICP parameters
-        float diagonal = ideal_mesh.getBoundingBox().diagonal();
-        MR::ICPProperties icpParams;
-        icpParams.distThresholdSq = MR::sqr(diagonal * 0.1f); // Use points pairs with maximum distance specified
-        icpParams.exitVal = diagonal * 0.003f;                // Stop when distance reached
+    /**
+     * @brief Adds a stage computing local ICP alignment between the ideal and defect meshes.
+     *
+     * @param ideal_mesh The ideal (reference) mesh.
+     * @param defect_mesh The defect mesh to be aligned.
+     * @param settings ICP parameters.
+     * @return Port<MR::AffineXf3f> The transformation of the defect mesh.
+     */
+    Port<MR::AffineXf3f> Pipeline::localICP(Port<MR::Mesh> ideal_mesh, Port<MR::Mesh> defect_mesh, const ICPSettings &settings)
+    {
+        return addStage<MR::AffineXf3f>("local ICP", {ideal_mesh.node, defect_mesh.node},
+                                        [settings](const StageInputs &in) -> MR::Expected<StageValue>
+                                        {
+                                            auto xf = Stages::localICP(std::get<MR::Mesh>(*in[0]), std::get<MR::Mesh>(*in[1]), settings);
+                                            std::cout << "Local ICP transformation: " << Stages::affineToString(xf) << std::endl;
+                                            return xf;
+                                        });
+    }
 
-        MR::ICP icp(MR::MeshOrPoints{MR::MeshPart{defect_mesh}},
-                    MR::MeshOrPoints{MR::MeshPart{ideal_mesh}},
-                    MR::AffineXf3f(), MR::AffineXf3f(),
-                    diagonal * 0.01f); // To sample points from object
-        icp.setParams(icpParams);
-        MR::AffineXf3f xf = icp.calculateTransformation();
-        defect_mesh.transform(xf);
+    /**
+     * @brief Adds a stage computing local ICP alignment between the ideal mesh and a scanned point cloud.
+     *
+     * @param ideal_mesh The ideal (reference) mesh.
+     * @param defect_cloud The scan of the defect part to be aligned.
+     * @param settings ICP parameters.
+     * @return Port<MR::AffineXf3f> The transformation of the scan.
+     */
+    Port<MR::AffineXf3f> Pipeline::localICP(Port<MR::Mesh> ideal_mesh, Port<MR::PointCloud> defect_cloud, const ICPSettings &settings)
+    {
+        return addStage<MR::AffineXf3f>("local ICP", {ideal_mesh.node, defect_cloud.node},
+                                        [settings](const StageInputs &in) -> MR::Expected<StageValue>
+                                        {
+                                            auto xf = Stages::localICP(std::get<MR::Mesh>(*in[0]), std::get<MR::PointCloud>(*in[1]), settings);
+                                            std::cout << "Local ICP transformation: " << Stages::affineToString(xf) << std::endl;
+                                            return xf;
+                                        });
     }
 
     /**
-     * @brief Performs a boolean operation (Difference) on the ideal and defect meshes.
+     * @brief Adds a stage computing global ICP alignment between the ideal and defect meshes.
      *
-     * @param ideal_mesh Reference to the ideal mesh.
-     * @param defect_mesh Reference to the defect mesh.
+     * @param ideal_mesh The ideal mesh, kept fixed.
+     * @param defect_mesh The defect mesh to be aligned.
+     * @param settings ICP parameters.
+     * @return Port<MR::AffineXf3f> The transformation of the defect mesh.
      */
-    void Pipeline::performBooleanOperation(MR::Mesh &ideal_mesh, MR::Mesh &defect_mesh)
+    Port<MR::AffineXf3f> Pipeline::globalICP(Port<MR::Mesh> ideal_mesh, Port<MR::Mesh> defect_mesh, const ICPSettings &settings)
     {
-        std::cout << "Performing boolean operation (DifferenceAB)..." << std::endl;
-        MR::BooleanResult result = MR::boolean(ideal_mesh, defect_mesh, MR::BooleanOperation::DifferenceAB);
-        if (!result.valid())
+        return addStage<MR::AffineXf3f>("global ICP", {ideal_mesh.node, defect_mesh.node},
+                                        [settings](const StageInputs &in) -> MR::Expected<StageValue>
+                                        {
+                                            auto xf = Stages::globalICP(std::get<MR::Mesh>(*in[0]), std::get<MR::Mesh>(*in[1]), settings);
+                                            std::cout << "\nGlobal ICP transformation: " << Stages::affineToString(xf) << std::endl;
+                                            return xf;
+                                        });
+    }
+
+    /**
+     * @brief Adds a stage applying a transformation to the mesh.
+     *
+     * @param mesh The input mesh.
+     * @param xf The transformation, e.g. from an ICP stage.
+     * @return Port<MR::Mesh> The transformed mesh.
+     */
+    Port<MR::Mesh> Pipeline::transform(Port<MR::Mesh> mesh, Port<MR::AffineXf3f> xf)
+    {
+        return addStage<MR::Mesh>("transform", {mesh.node, xf.node},
+                                  [](const StageInputs &in) -> MR::Expected<StageValue>
+                                  {
+                                      MR::Mesh result = std::get<MR::Mesh>(*in[0]);
+                                      result.transform(std::get<MR::AffineXf3f>(*in[1]));
+                                      return result;
+                                  });
+    }
+
+    /**
+     * @brief Adds a stage applying a transformation to the point cloud.
+     *
+     * @param cloud The input cloud.
+     * @param xf The transformation, e.g. from an ICP stage.
+     * @return Port<MR::PointCloud> The transformed cloud.
+     */
+    Port<MR::PointCloud> Pipeline::transform(Port<MR::PointCloud> cloud, Port<MR::AffineXf3f> xf)
+    {
+        return addStage<MR::PointCloud>("transform", {cloud.node, xf.node},
+                                        [](const StageInputs &in) -> MR::Expected<StageValue>
+                                        {
+                                            MR::PointCloud result = std::get<MR::PointCloud>(*in[0]);
+                                            Stages::transformPoints(result, std::get<MR::AffineXf3f>(*in[1]));
+                                            return result;
+                                        });
+    }
+
+    /**
+     * @brief Adds a stage performing a boolean operation on two meshes.
+     *
+     * @param mesh_a The first mesh.
+     * @param mesh_b The second mesh.
+     * @param operation The boolean operation.
+     * @return Port<MR::Mesh> The result mesh.
+     */
+    Port<MR::Mesh> Pipeline::booleanOperation(Port<MR::Mesh> mesh_a, Port<MR::Mesh> mesh_b, MR::BooleanOperation operation)
+    {
+        auto result = addStage<MR::Mesh>("boolean", {mesh_a.node, mesh_b.node},
+                                  [operation](const StageInputs &in) -> MR::Expected<StageValue>
+                                  {
+                                      auto result = Stages::booleanOperation(std::get<MR::Mesh>(*in[0]), std::get<MR::Mesh>(*in[1]), operation);
+                                      if (!result)
+                                          return MR::unexpected(result.error());
+                                      return std::move(*result);
+                                  });
+        if (result.node < nodes_.size())
+            booleans_[result.node] = BooleanStage{mesh_a.node, mesh_b.node, operation};
+        return result;
+    }
+
+    /**
+     * @brief Checks that a mesh node is the DifferenceAB boolean of the given ideal and defect nodes.
+     *
+     * @param missing_material The node to check.
+     * @param ideal_mesh The ideal mesh.
+     * @param defect_mesh The aligned defect mesh.
+     * @return true if missing_material is ideal_mesh minus defect_mesh.
+     */
+    bool Pipeline::isDifference(Port<MR::Mesh> missing_material, Port<MR::Mesh> ideal_mesh, Port<MR::Mesh> defect_mesh) const
+    {
+        auto it = booleans_.find(missing_material.node);
+        return it != booleans_.end() && it->second.operation == MR::BooleanOperation::DifferenceAB &&
+               it->second.mesh_a == ideal_mesh.node && it->second.mesh_b == defect_mesh.node;
+    }
+
+    /**
+     * @brief Adds a stage computing the signed deviation map of the defect mesh against the ideal mesh.
+     *
+     * When the ideal mesh node is also the ICP reference, the AABB tree built for ICP is reused.
+     *
+     * @param ideal_mesh The ideal mesh.
+     * @param defect_mesh The aligned defect mesh.
+     * @param settings Histogram, pass/fail thresholds and output paths.
+     * @return Port<DeviationReport> The deviation report, also marked as a pipeline output.
+     */
+    Port<DeviationReport> Pipeline::deviationAnalysis(Port<MR::Mesh> ideal_mesh, Port<MR::Mesh> defect_mesh,
+                                                      const DeviationSettings &settings)
+    {
+        auto report = addStage<DeviationReport>("deviation analysis", {ideal_mesh.node, defect_mesh.node},
+                                                [settings](const StageInputs &in) -> MR::Expected<StageValue>
+                                                {
+                                                    DeviationAnalysis analysis(settings);
+                                                    DeviationReport result = analysis.run(std::get<MR::Mesh>(*in[0]), std::get<MR::Mesh>(*in[1]));
+                                                    result.print(std::cout);
+                                                    return result;
+                                                });
+        markOutput(report.node);
+        return report;
+    }
+
+    /**
+     * @brief Adds a stage computing the signed deviation map, taking the missing volume from a DifferenceAB.
+     *
+     * The difference is an optional input: if the boolean fails, the deviations are still computed
+     * and reported, with a NaN missing volume and a FAIL result.
+     *
+     * @param ideal_mesh The ideal mesh.
+     * @param defect_mesh The aligned defect mesh.
+     * @param missing_material The DifferenceAB boolean stage of ideal_mesh and defect_mesh.
+     * @param settings Histogram, pass/fail thresholds and output paths.
+     * @return Port<DeviationReport> The deviation report, also marked as a pipeline output.
+     */
+    Port<DeviationReport> Pipeline::deviationAnalysis(Port<MR::Mesh> ideal_mesh, Port<MR::Mesh> defect_mesh,
+                                                      Port<MR::Mesh> missing_material, const DeviationSettings &settings)
+    {
+        if (!isDifference(missing_material, ideal_mesh, defect_mesh))
         {
-            std::cerr << result.errorString << std::endl;
-            return;
+            std::cerr << "The missing material of the deviation analysis must be the difference_ab boolean of its ideal and defect meshes" << std::endl;
+            valid_ = false;
+            return {};
         }
-        // save result to STL file
-        MR::Mesh resultMesh = *result;
-        saveMesh(resultMesh, "../meshes/out_boolean.stl");
+        auto report = addStage<DeviationReport>("deviation analysis", {ideal_mesh.node, defect_mesh.node, missing_material.node},
+                                                [settings](const StageInputs &in) -> MR::Expected<StageValue>
+                                                {
+                                                    DeviationAnalysis analysis(settings);
+                                                    const MR::Mesh *missing = in[2] ? &std::get<MR::Mesh>(*in[2]) : nullptr;
+                                                    DeviationReport result = analysis.run(std::get<MR::Mesh>(*in[0]), std::get<MR::Mesh>(*in[1]), missing);
+                                                    result.print(std::cout);
+                                                    return result;
+                                                },
+                                                2);
+        markOutput(report.node);
+        return report;
     }
 
     /**
-     * @brief Saves the resulting mesh to a specified file path.
+     * @brief Adds a stage saving the mesh, the stage is marked as a pipeline output.
      *
-     * @param result The mesh to be saved.
+     * @param mesh The mesh to be saved.
      * @param path The file path where the mesh will be saved.
+     * @return Port<MR::Mesh> The same mesh, so saving can be chained.
+     */
+    Port<MR::Mesh> Pipeline::saveMesh(Port<MR::Mesh> mesh, const std::filesystem::path &path)
+    {
+        auto saved = addStage<MR::Mesh>("save " + path.filename().string(), {mesh.node},
+                                        [path](const StageInputs &in) -> MR::Expected<StageValue>
+                                        {
+                                            const MR::Mesh &result = std::get<MR::Mesh>(*in[0]);
+                                            if (auto res = Stages::saveMesh(result, path); !res)
+                                                return MR::unexpected(res.error());
+                                            return result;
+                                        });
+        markOutput(saved.node);
+        return saved;
+    }
+
+    /**
+     * @brief Adds a stage saving the point cloud, the stage is marked as a pipeline output.
+     *
+     * @param cloud The cloud to be saved.
+     * @param path The file path where the cloud will be saved.
+     * @return Port<MR::PointCloud> The same cloud, so saving can be chained.
+     */
+    Port<MR::PointCloud> Pipeline::savePoints(Port<MR::PointCloud> cloud, const std::filesystem::path &path)
+    {
+        auto saved = addStage<MR::PointCloud>("save " + path.filename().string(), {cloud.node},
+                                              [path](const StageInputs &in) -> MR::Expected<StageValue>
+                                              {
+                                                  const MR::PointCloud &result = std::get<MR::PointCloud>(*in[0]);
+                                                  if (auto res = Stages::savePoints(result, path); !res)
+                                                      return MR::unexpected(res.error());
+                                                  return result;
+                                              });
+        markOutput(saved.node);
+        return saved;
+    }
+
+    /**
+     * @brief Marks the node as a pipeline output.
+     *
+     * @param node The node index.
+     */
+    void Pipeline::markOutput(size_t node)
+    {
+        outputs_.push_back(node);
+    }
+
+    /**
+     * @brief Executes the mesh processing pipeline, i.e. evaluates all outputs.
+     *
+     * @return 0 on success, -1 if any stage failed.
+     */
+    int Pipeline::run()
+    {
+        if (!valid_)
+        {
+            std::cerr << "Pipeline has stages with unknown inputs" << std::endl;
+            return -1;
+        }
+        if (outputs_.empty())
+        {
+            std::cerr << "Pipeline has no outputs" << std::endl;
+            return -1;
+        }
+        return evaluate(outputs_) ? 0 : -1;
+    }
+
+    /**
+     * @brief Evaluates the targets and every stage they depend on.
+     *
+     * Stages which are already computed are reused, stages not needed by the targets are skipped.
+     * A stage is started as soon as all its inputs are ready, so independent branches run in parallel.
+     * A failed stage skips the stages which need its value; stages with it as an optional input still run.
+     *
+     * @param targets The nodes to evaluate.
+     * @return true if all targets are computed, false if a stage failed.
      */
-    void Pipeline::saveMesh(const MR::Mesh &result, const std::string &path)
+    bool Pipeline::evaluate(const std::vector<size_t> &targets)
     {
-        MR::MeshSave::toAnySupportedFormat(result, path);
-        std::cout << "Saved the result mesh to " << path << std::endl;
+        // collect the stages the targets depend on which are not computed yet
+        std::vector<char> needed(nodes_.size(), 0);
+        std::vector<size_t> stack;
+        for (size_t target : targets)
+        {
+            if (target >= nodes_.size())
+            {
+                std::cerr << "Unknown pipeline node " << target << std::endl;
+                return false;
+            }
+            stack.push_back(target);
+        }
+        while (!stack.empty())
+        {
+            size_t node = stack.back();
+            stack.pop_back();
+            if (needed[node] || nodes_[node].value)
+                continue;
+            needed[node] = 1;
+            for (size_t input : nodes_[node].inputs)
+                stack.push_back(input);
+        }
+
+        // count not computed inputs of every needed stage, stages without them start right away
+        std::vector<std::atomic<int>> pending(nodes_.size());
+        std::vector<std::vector<size_t>> successors(nodes_.size());
+        std::vector<size_t> ready;
+        for (size_t node = 0; node < nodes_.size(); ++node)
+        {
+            if (!needed[node])
+                continue;
+            int count = 0;
+            for (size_t input : nodes_[node].inputs)
+            {
+                if (needed[input])
+                {
+                    successors[input].push_back(node);
+                    ++count;
+                }
+            }
+            pending[node] = count;
+            if (count == 0)
+                ready.push_back(node);
+        }
+
+        std::atomic<bool> failed = false;
+        tbb::task_group group;
+        std::function<void(size_t)> runNode = [&](size_t node)
+        {
+            if (!computeNode(node))
+                failed = true;
+            // successors start either way, computeNode skips those which need the failed value
+            for (size_t successor : successors[node])
+                if (--pending[successor] == 0)
+                    group.run([&runNode, successor]
+                              { runNode(successor); });
+        };
+        for (size_t node : ready)
+            group.run([&runNode, node]
+                      { runNode(node); });
+        group.wait();
+
+        return !failed;
     }
 
     /**
-     * @brief Callback function to report progress during operations.
+     * @brief Computes a single stage whose inputs are all evaluated.
      *
-     * @param v A float value representing the progress (0.0 to 1.0).
-     * @return true if the operation should continue, false otherwise.
+     * @param node The node index.
+     * @return true if the stage succeeded, false if it or one of its required inputs failed.
      */
-    bool Pipeline::onProgress(float v)
+    bool Pipeline::computeNode(size_t node)
     {
-        static int gProgress = -1;
-        int progress = static_cast<int>(10.f * v);
-        if (progress != gProgress)
+        static std::mutex logMutex;
+        Node &stage = nodes_[node];
+
+        StageInputs inputs;
+        inputs.reserve(stage.inputs.size());
+        for (size_t i = 0; i < stage.inputs.size(); ++i)
+        {
+            const auto &value = nodes_[stage.inputs[i]].value;
+            if (!value && i < stage.required)
+            {
+                std::lock_guard lock(logMutex);
+                std::cerr << "\n[" << node << "] " << stage.name << " skipped, input [" << stage.inputs[i] << "] failed" << std::endl;
+                return false;
+            }
+            inputs.push_back(value ? &*value : nullptr);
+        }
+
+        {
+            std::lock_guard lock(logMutex);
+            std::cout << "\n[" << node << "] " << stage.name << "..." << std::endl;
+        }
+        auto start = std::chrono::steady_clock::now();
+        auto value = stage.func(inputs);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::lock_guard lock(logMutex);
+        if (!value)
         {
-            gProgress = progress;
-            std::cout << "\r" << std::flush << ((progress + 1) * 10) << "% completed.";
+            std::cerr << "\n[" << node << "] " << stage.name << " failed: " << value.error() << std::endl;
+            return false;
         }
+        std::cout << "\n[" << node << "] " << stage.name << " done in " << elapsed.count() << " s" << std::endl;
+        stage.value = std::move(*value);
         return true;
     }
 
-} // namespace DMD
\ No newline at end of file
+    /**
+     * @brief Adds a node to the graph.
+     *
+     * @param name The stage name used in logs.
+     * @param type The type of the stage value.
+     * @param inputs The input nodes, must already exist.
+     * @param func Computes the stage value from the input values.
+     * @param required The number of leading inputs the stage needs, the others are optional.
+     * @return size_t The index of the new node, or size_t(-1) if an input does not exist.
+     */
+    size_t Pipeline::addNode(std::string name, std::type_index type, std::vector<size_t> inputs, StageFunc func,
+                             size_t required)
+    {
+        for (size_t input : inputs)
+        {
+            if (input >= nodes_.size())
+            {
+                // e.g. a default constructed Port, the stage is dropped and run() fails
+                std::cerr << "Pipeline stage " << name << " has an unknown input node " << input << std::endl;
+                valid_ = false;
+                return size_t(-1);
+            }
+        }
+        required = std::min(required, inputs.size());
+        nodes_.push_back(Node{std::move(name), type, std::move(inputs), required, std::move(func), std::nullopt});
+        return nodes_.size() - 1;
+    }
+
+} // namespace DMD
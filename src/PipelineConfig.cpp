@@ -0,0 +1,543 @@
+/**
+ * @file PipelineConfig.cpp
+ * @author DMD team, IU
+ * @brief Implementation of PipelineConfig class
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
+ *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ */
+
+#include "PipelineConfig.h"
+
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+
+namespace DMD
+{
+
+    namespace
+    {
+        /**
+         * @brief Prints a config error with the line number.
+         */
+        bool configError(int line_number, const std::string &message)
+        {
+            std::cerr << "Config line " << line_number << ": " << message << std::endl;
+            return false;
+        }
+
+        /**
+         * @brief Parses an optional numeric argument.
+         *
+         * @param args The stage arguments.
+         * @param index The index of the argument.
+         * @param value Receives the parsed value, kept unchanged if the argument is missing.
+         * @return false if the argument is present but not a number.
+         */
+        template <typename T>
+        bool optionalNumber(const std::vector<std::string> &args, size_t index, T &value)
+        {
+            if (index >= args.size())
+                return true;
+            std::istringstream iss(args[index]);
+            iss >> value;
+            return !iss.fail() && iss.eof();
+        }
+
+        /**
+         * @brief Parses a comma separated list of numbers, e.g. "0,0,1,2.5".
+         *
+         * @param text The list.
+         * @param count The expected number of values.
+         * @return std::optional<std::vector<float>> The values, or empty on a parse error.
+         */
+        std::optional<std::vector<float>> numberList(const std::string &text, size_t count)
+        {
+            std::vector<float> values;
+            std::istringstream iss(text);
+            std::string item;
+            while (std::getline(iss, item, ','))
+            {
+                float value = 0.f;
+                if (!optionalNumber({item}, 0, value))
+                    return std::nullopt;
+                values.push_back(value);
+            }
+            if (values.size() != count)
+                return std::nullopt;
+            return values;
+        }
+
+        /**
+         * @brief Parses the key=value options of the preprocess stage.
+         *
+         * @param options The options, e.g. {"align=1", "voxel=0.5", "outliers=20,2"}.
+         * @param settings Receives the parsed settings.
+         * @param line_number The line number for error messages.
+         * @return true if all options were parsed, false otherwise.
+         */
+        bool preprocessOptions(const std::vector<std::string> &options, PointCloudSettings &settings, int line_number)
+        {
+            for (const std::string &option : options)
+            {
+                auto eq = option.find('=');
+                if (eq == std::string::npos)
+                    return configError(line_number, "expected key=value, got " + option);
+                const std::string key = option.substr(0, eq);
+                const std::string value = option.substr(eq + 1);
+
+                std::optional<std::vector<float>> v;
+                if (key == "align" && (v = numberList(value, 1)))
+                    settings.pcaAlign = (*v)[0] != 0.f;
+                else if ((key == "crop_plane" || key == "crop_plane_mid") && (v = numberList(value, 4)))
+                {
+                    settings.crop = CropMode::Plane;
+                    settings.planeNormal = MR::Vector3f((*v)[0], (*v)[1], (*v)[2]);
+                    (key == "crop_plane" ? settings.planeOffset : settings.planeMidpointScale) = (*v)[3];
+                }
+                else if (key == "crop_box" && (v = numberList(value, 6)))
+                {
+                    settings.crop = CropMode::Box;
+                    settings.cropBox = MR::Box3f(MR::Vector3f((*v)[0], (*v)[1], (*v)[2]), MR::Vector3f((*v)[3], (*v)[4], (*v)[5]));
+                }
+                else if (key == "voxel" && (v = numberList(value, 1)))
+                    settings.voxelSize = (*v)[0];
+                else if (key == "outliers" && (v = numberList(value, 2)))
+                {
+                    settings.outlierNeighbors = static_cast<int>((*v)[0]);
+                    settings.outlierStdRatio = (*v)[1];
+                }
+                else if (key == "normals" && (v = numberList(value, 1)))
+                    settings.normalNeighbors = static_cast<int>((*v)[0]);
+                else
+                    return configError(line_number, "wrong preprocess option " + option);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Converts the boolean operation name to MR::BooleanOperation.
+         */
+        std::optional<MR::BooleanOperation> booleanOperationFromString(const std::string &name)
+        {
+            if (name == "difference_ab")
+                return MR::BooleanOperation::DifferenceAB;
+            if (name == "difference_ba")
+                return MR::BooleanOperation::DifferenceBA;
+            if (name == "union")
+                return MR::BooleanOperation::Union;
+            if (name == "intersection")
+                return MR::BooleanOperation::Intersection;
+            return std::nullopt;
+        }
+    } // namespace
+
+    /**
+     * @brief Constructor for PipelineConfig class
+     *
+     * @param pipeline The pipeline the parsed stages are added to.
+     */
+    PipelineConfig::PipelineConfig(Pipeline &pipeline)
+        : pipeline_(pipeline) {}
+
+    /**
+     * @brief Defines a variable used as $name or ${name} anywhere in stage arguments.
+     *
+     * @param name The variable name without $.
+     * @param value The value.
+     */
+    void PipelineConfig::define(const std::string &name, const std::string &value)
+    {
+        variables_[name] = value;
+    }
+
+    /**
+     * @brief Parses all stages of a config file.
+     *
+     * @param path The config file path.
+     * @return true if every line was parsed, false otherwise.
+     */
+    bool PipelineConfig::parseFile(const std::filesystem::path &path)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            std::cerr << "Error opening config " << path << std::endl;
+            return false;
+        }
+        std::string line;
+        int line_number = 0;
+        while (std::getline(in, line))
+        {
+            if (!parseLine(line, ++line_number))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Cuts the line at the first # outside of double quotes.
+     *
+     * Quotes follow std::quoted, so \" inside a quoted argument does not end it.
+     *
+     * @param line The line.
+     * @return std::string The line without the comment.
+     */
+    std::string PipelineConfig::stripComment(const std::string &line)
+    {
+        bool quoted = false;
+        for (size_t i = 0; i < line.size(); ++i)
+        {
+            if (quoted && line[i] == '\\')
+                ++i;
+            else if (line[i] == '"')
+                quoted = !quoted;
+            else if (!quoted && line[i] == '#')
+                return line.substr(0, i);
+        }
+        return line;
+    }
+
+    /**
+     * @brief Parses a single stage line: [name =] stage args...
+     *
+     * Empty lines are ignored and # starts a comment up to the end of the line, also after a stage.
+     * Arguments with spaces or # can be quoted.
+     *
+     * @param line The line.
+     * @param line_number The line number for error messages.
+     * @return true if the line was parsed, false otherwise.
+     */
+    bool PipelineConfig::parseLine(const std::string &line, int line_number)
+    {
+        std::istringstream iss(stripComment(line));
+        std::vector<std::string> tokens;
+        std::string token;
+        while (iss >> std::quoted(token))
+        {
+            auto expanded = expandVariables(token, line_number);
+            if (!expanded)
+                return false;
+            tokens.push_back(*expanded);
+        }
+        if (tokens.empty())
+            return true;
+
+        std::string name;
+        if (tokens.size() >= 2 && tokens[1] == "=")
+        {
+            name = tokens[0];
+            tokens.erase(tokens.begin(), tokens.begin() + 2);
+            if (names_.count(name))
+                return configError(line_number, "stage " + name + " is already defined");
+        }
+        if (tokens.empty())
+            return configError(line_number, "missing stage after " + name + " =");
+
+        return addStage(name, tokens, line_number);
+    }
+
+    /**
+     * @brief Replaces every $name and ${name} in the token by the variable value.
+     *
+     * $name ends at the first character which is not a letter, digit or _, so "$out/mesh.stl"
+     * works; ${name} is for names followed by such characters. A $ not followed by a name is kept.
+     *
+     * @param token The token.
+     * @param line_number The line number for error messages.
+     * @return std::optional<std::string> The expanded token, or empty if a variable is undefined.
+     */
+    std::optional<std::string> PipelineConfig::expandVariables(const std::string &token, int line_number) const
+    {
+        auto isNameChar = [](char c)
+        { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+
+        std::string result;
+        size_t pos = 0;
+        while (pos < token.size())
+        {
+            size_t dollar = token.find('$', pos);
+            if (dollar == std::string::npos)
+            {
+                result += token.substr(pos);
+                break;
+            }
+            result += token.substr(pos, dollar - pos);
+
+            std::string name;
+            size_t end = dollar + 1;
+            if (end < token.size() && token[end] == '{')
+            {
+                size_t close = token.find('}', end);
+                if (close == std::string::npos)
+                {
+                    configError(line_number, "missing } in " + token);
+                    return std::nullopt;
+                }
+                name = token.substr(end + 1, close - end - 1);
+                end = close + 1;
+            }
+            else
+            {
+                while (end < token.size() && isNameChar(token[end]))
+                    ++end;
+                name = token.substr(dollar + 1, end - dollar - 1);
+            }
+
+            if (name.empty())
+            {
+                result += '$';
+                pos = dollar + 1;
+                continue;
+            }
+            auto it = variables_.find(name);
+            if (it == variables_.end())
+            {
+                configError(line_number, "undefined variable $" + name);
+                return std::nullopt;
+            }
+            result += it->second;
+            pos = end;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Looks up a named stage and checks its output type.
+     *
+     * @param name The stage name.
+     * @param line_number The line number for error messages.
+     * @return std::optional<Port<T>> The typed port, or empty if not found or of another type.
+     */
+    template <typename T>
+    std::optional<Port<T>> PipelineConfig::lookup(const std::string &name, int line_number) const
+    {
+        auto it = names_.find(name);
+        if (it == names_.end())
+        {
+            configError(line_number, "unknown stage " + name);
+            return std::nullopt;
+        }
+        auto port = pipeline_.port<T>(it->second);
+        if (!port)
+            configError(line_number, "stage " + name + " has a wrong output type");
+        return port;
+    }
+
+    /**
+     * @brief Checks whether the named stage produces a point cloud.
+     *
+     * @param name The stage name.
+     * @return true if the stage exists and produces MR::PointCloud.
+     */
+    bool PipelineConfig::producesPoints(const std::string &name) const
+    {
+        auto it = names_.find(name);
+        return it != names_.end() && pipeline_.port<MR::PointCloud>(it->second).has_value();
+    }
+
+    /**
+     * @brief Adds the stage described by the arguments to the pipeline.
+     *
+     * @param name The stage name, may be empty for sinks like save.
+     * @param args The stage keyword followed by its arguments.
+     * @param line_number The line number for error messages.
+     * @return true if the stage was added, false otherwise.
+     */
+    bool PipelineConfig::addStage(const std::string &name, const std::vector<std::string> &args, int line_number)
+    {
+        const std::string &stage = args[0];
+        auto expectArgs = [&](size_t min, size_t max)
+        {
+            if (args.size() - 1 >= min && args.size() - 1 <= max)
+                return true;
+            return configError(line_number, "wrong number of arguments for " + stage);
+        };
+
+        std::optional<size_t> node;
+        if (stage == "load")
+        {
+            if (!expectArgs(1, 1))
+                return false;
+            node = pipeline_.loadMesh(args[1]).node;
+        }
+        else if (stage == "fill")
+        {
+            if (!expectArgs(1, 1))
+                return false;
+            if (auto mesh = lookup<MR::Mesh>(args[1], line_number))
+                node = pipeline_.fillHoles(*mesh).node;
+        }
+        else if (stage == "rebuild")
+        {
+            float voxelSize = Stages::defaultVoxelSize;
+            if (!expectArgs(1, 2))
+                return false;
+            if (!optionalNumber(args, 2, voxelSize) || voxelSize <= 0.f)
+                return configError(line_number, "wrong voxel size " + args[2]);
+            if (auto mesh = lookup<MR::Mesh>(args[1], line_number))
+                node = pipeline_.reBuild(*mesh, voxelSize).node;
+        }
+        else if (stage == "rebuild_nb")
+        {
+            NarrowBandSettings settings;
+            if (!expectArgs(1, 4))
+                return false;
+            if (!optionalNumber(args, 2, settings.voxelSize) || settings.voxelSize <= 0.f)
+                return configError(line_number, "wrong voxel size " + args[2]);
+            if (!optionalNumber(args, 3, settings.adaptivity) || settings.adaptivity < 0.f || settings.adaptivity > 1.f)
+                return configError(line_number, "wrong adaptivity " + args[3]);
+            if (!optionalNumber(args, 4, settings.bandWidth) || settings.bandWidth <= 0.f)
+                return configError(line_number, "wrong band width " + args[4]);
+            if (auto mesh = lookup<MR::Mesh>(args[1], line_number))
+                node = pipeline_.reBuildNarrowBand(*mesh, settings).node;
+        }
+        else if (stage == "icp_local" || stage == "icp_global")
+        {
+            ICPSettings settings;
+            if (!expectArgs(2, 3))
+                return false;
+            if (!optionalNumber(args, 3, settings.iterLimit))
+                return configError(line_number, "wrong iteration limit " + args[3]);
+            auto ideal = lookup<MR::Mesh>(args[1], line_number);
+            if (stage == "icp_local" && producesPoints(args[2]))
+            {
+                // a preprocessed scan is aligned directly, without meshing it
+                auto cloud = lookup<MR::PointCloud>(args[2], line_number);
+                if (ideal && cloud)
+                    node = pipeline_.localICP(*ideal, *cloud, settings).node;
+            }
+            else
+            {
+                auto defect = lookup<MR::Mesh>(args[2], line_number);
+                if (ideal && defect)
+                    node = stage == "icp_local" ? pipeline_.localICP(*ideal, *defect, settings).node
+                                                : pipeline_.globalICP(*ideal, *defect, settings).node;
+            }
+        }
+        else if (stage == "transform")
+        {
+            if (!expectArgs(2, 2))
+                return false;
+            auto xf = lookup<MR::AffineXf3f>(args[2], line_number);
+            if (producesPoints(args[1]))
+            {
+                auto cloud = lookup<MR::PointCloud>(args[1], line_number);
+                if (cloud && xf)
+                    node = pipeline_.transform(*cloud, *xf).node;
+            }
+            else
+            {
+                auto mesh = lookup<MR::Mesh>(args[1], line_number);
+                if (mesh && xf)
+                    node = pipeline_.transform(*mesh, *xf).node;
+            }
+        }
+        else if (stage == "load_points")
+        {
+            if (!expectArgs(1, 1))
+                return false;
+            node = pipeline_.loadPoints(args[1]).node;
+        }
+        else if (stage == "preprocess")
+        {
+            PointCloudSettings settings;
+            if (!expectArgs(1, 7))
+                return false;
+            if (!preprocessOptions({args.begin() + 2, args.end()}, settings, line_number))
+                return false;
+            if (auto cloud = lookup<MR::PointCloud>(args[1], line_number))
+                node = pipeline_.preprocessPoints(*cloud, settings).node;
+        }
+        else if (stage == "save_points")
+        {
+            if (!expectArgs(2, 2))
+                return false;
+            if (auto cloud = lookup<MR::PointCloud>(args[1], line_number))
+                node = pipeline_.savePoints(*cloud, args[2]).node;
+        }
+        else if (stage == "boolean")
+        {
+            if (!expectArgs(2, 3))
+                return false;
+            auto operation = booleanOperationFromString(args.size() > 3 ? args[3] : "difference_ab");
+            if (!operation)
+                return configError(line_number, "unknown boolean operation " + args[3]);
+            auto mesh_a = lookup<MR::Mesh>(args[1], line_number);
+            auto mesh_b = lookup<MR::Mesh>(args[2], line_number);
+            if (mesh_a && mesh_b)
+                node = pipeline_.booleanOperation(*mesh_a, *mesh_b, *operation).node;
+        }
+        else if (stage == "deviation")
+        {
+            if (!expectArgs(2, 6))
+                return false;
+            DeviationSettings settings;
+            std::string missing;
+            bool hasPrefix = false;
+            for (size_t i = 3; i < args.size(); ++i)
+            {
+                const std::string &arg = args[i];
+                std::optional<std::vector<float>> v;
+                if (arg.starts_with("missing="))
+                    missing = arg.substr(8);
+                else if (arg.starts_with("max_deviation="))
+                {
+                    if (!(v = numberList(arg.substr(14), 1)) || (*v)[0] < 0.f)
+                        return configError(line_number, "wrong deviation option " + arg);
+                    settings.maxDeviation = (*v)[0];
+                }
+                else if (arg.starts_with("max_missing_volume="))
+                {
+                    if (!(v = numberList(arg.substr(19), 1)) || (*v)[0] < 0.f)
+                        return configError(line_number, "wrong deviation option " + arg);
+                    settings.maxMissingVolume = (*v)[0];
+                }
+                else if (!hasPrefix)
+                {
+                    hasPrefix = true;
+                    settings.plyPath = arg + ".ply";
+                    settings.binaryPath = arg + ".bin";
+                    settings.histogramPath = arg + "_histogram.csv";
+                }
+                else
+                    return configError(line_number, "wrong deviation option " + arg);
+            }
+            auto ideal = lookup<MR::Mesh>(args[1], line_number);
+            auto defect = lookup<MR::Mesh>(args[2], line_number);
+            if (!missing.empty())
+            {
+                // the DifferenceAB already in the graph gives the missing volume
+                auto missingMaterial = lookup<MR::Mesh>(missing, line_number);
+                if (ideal && defect && missingMaterial)
+                {
+                    if (!pipeline_.isDifference(*missingMaterial, *ideal, *defect))
+                        return configError(line_number, "missing=" + missing + " must be a boolean " + args[1] + " " + args[2] + " difference_ab stage");
+                    node = pipeline_.deviationAnalysis(*ideal, *defect, *missingMaterial, settings).node;
+                }
+            }
+            else if (ideal && defect)
+                node = pipeline_.deviationAnalysis(*ideal, *defect, settings).node;
+        }
+        else if (stage == "save")
+        {
+            if (!expectArgs(2, 2))
+                return false;
+            if (auto mesh = lookup<MR::Mesh>(args[1], line_number))
+                node = pipeline_.saveMesh(*mesh, args[2]).node;
+        }
+        else
+        {
+            return configError(line_number, "unknown stage type " + stage);
+        }
+
+        if (!node)
+            return false;
+        if (!name.empty())
+            names_[name] = *node;
+        return true;
+    }
+
+} // namespace DMD
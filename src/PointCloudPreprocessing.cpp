@@ -0,0 +1,617 @@
+/**
+ * @file PointCloudPreprocessing.cpp
+ * @author DMD team, IU
+ * @brief Implementation of PointCloudPreprocessing class
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
+ *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ *                oneTBB - every step runs in parallel over the cloud.
+ */
+
+#include "PointCloudPreprocessing.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <MRMesh/MRMatrix3.h>
+#include <MRMesh/MRSymMatrix3.h>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_scan.h>
+#include <tbb/parallel_sort.h>
+
+namespace DMD
+{
+
+    namespace
+    {
+        using Range = tbb::blocked_range<size_t>;
+
+        /**
+         * @brief Packs integer cell coordinates into one 64 bit key, 21 bits per axis.
+         *        Only for grids of less than 2^21 cells per axis, see NeighborGrid.
+         */
+        std::uint64_t cellKey(const MR::Vector3i &c)
+        {
+            constexpr std::uint64_t mask = (1u << 21) - 1;
+            return ((std::uint64_t(c.x) & mask) << 42) | ((std::uint64_t(c.y) & mask) << 21) | (std::uint64_t(c.z) & mask);
+        }
+
+        /**
+         * @brief Computes the bounding box of the points with a parallel reduction.
+         */
+        MR::Box3f boundingBox(const std::vector<MR::Vector3f> &points)
+        {
+            return tbb::parallel_reduce(
+                Range(0, points.size()), MR::Box3f{},
+                [&](const Range &range, MR::Box3f box)
+                {
+                    for (size_t i = range.begin(); i < range.end(); ++i)
+                        box.include(points[i]);
+                    return box;
+                },
+                [](MR::Box3f a, const MR::Box3f &b)
+                {
+                    if (b.valid())
+                    {
+                        a.include(b.min);
+                        a.include(b.max);
+                    }
+                    return a;
+                });
+        }
+
+        /**
+         * @brief Computes the centroid of the points with a parallel reduction.
+         */
+        MR::Vector3d centroid(const std::vector<MR::Vector3f> &points)
+        {
+            MR::Vector3d sum = tbb::parallel_reduce(
+                Range(0, points.size()), MR::Vector3d{},
+                [&](const Range &range, MR::Vector3d acc)
+                {
+                    for (size_t i = range.begin(); i < range.end(); ++i)
+                        acc += MR::Vector3d(points[i]);
+                    return acc;
+                },
+                [](const MR::Vector3d &a, const MR::Vector3d &b)
+                { return a + b; });
+            return points.empty() ? sum : sum / double(points.size());
+        }
+
+        /**
+         * @brief Accumulates the covariance matrix of points around the center.
+         */
+        void addCovariance(MR::SymMatrix3d &cov, const MR::Vector3d &d)
+        {
+            cov.xx += d.x * d.x;
+            cov.xy += d.x * d.y;
+            cov.xz += d.x * d.z;
+            cov.yy += d.y * d.y;
+            cov.yz += d.y * d.z;
+            cov.zz += d.z * d.z;
+        }
+
+        /**
+         * @brief Lists the indices whose flag is set, in order, using a parallel prefix sum.
+         */
+        std::vector<size_t> keptIndices(const std::vector<char> &keep)
+        {
+            std::vector<size_t> offsets(keep.size());
+            const size_t count = tbb::parallel_scan(
+                Range(0, keep.size()), size_t(0),
+                [&](const Range &range, size_t sum, bool isFinal)
+                {
+                    for (size_t i = range.begin(); i < range.end(); ++i)
+                    {
+                        if (isFinal)
+                            offsets[i] = sum;
+                        sum += keep[i] ? 1 : 0;
+                    }
+                    return sum;
+                },
+                std::plus<size_t>());
+
+            std::vector<size_t> indices(count);
+            tbb::parallel_for(Range(0, keep.size()), [&](const Range &range)
+                              {
+                                  for (size_t i = range.begin(); i < range.end(); ++i)
+                                      if (keep[i])
+                                          indices[offsets[i]] = i; });
+            return indices;
+        }
+
+        /**
+         * @brief Copies the values at the given indices in parallel, an empty attribute stays empty.
+         */
+        template <typename T>
+        std::vector<T> gather(const std::vector<T> &values, const std::vector<size_t> &indices)
+        {
+            if (values.empty())
+                return {};
+            std::vector<T> result(indices.size());
+            tbb::parallel_for(Range(0, indices.size()), [&](const Range &range)
+                              {
+                                  for (size_t j = range.begin(); j < range.end(); ++j)
+                                      result[j] = values[indices[j]]; });
+            return result;
+        }
+
+        /**
+         * Uniform hash grid for k nearest neighbor queries. Points are sorted by cell,
+         * every cell stores its range in the sorted order.
+         */
+        class NeighborGrid
+        {
+        public:
+            using Neighbors = std::vector<std::pair<float, size_t>>; // squared distance, point index
+
+            // the search stops this many cells away, so isolated points do not scan the whole grid
+            static constexpr int maxRings = 16;
+
+            NeighborGrid(const std::vector<MR::Vector3f> &points, int k)
+                : points_(points)
+            {
+                MR::Box3f box = boundingBox(points);
+                origin_ = box.min;
+                float diagonal = box.diagonal();
+                // about k points in the 3x3x3 cells around a point of a surface scan,
+                // and less than 2^20 cells per axis so the 21 bit cellKey never wraps
+                cellSize_ = std::max({diagonal * std::sqrt(float(k) / std::max<size_t>(points.size(), 1)) * 0.5f,
+                                      diagonal / float(1 << 20), 1e-6f});
+                maxRing_ = std::min(static_cast<int>(std::ceil(diagonal / cellSize_)) + 1, maxRings);
+
+                std::vector<std::pair<std::uint64_t, size_t>> keys(points.size());
+                tbb::parallel_for(Range(0, points.size()), [&](const Range &range)
+                                  {
+                                      for (size_t i = range.begin(); i < range.end(); ++i)
+                                          keys[i] = {cellKey(cellOf(points[i])), i}; });
+                tbb::parallel_sort(keys.begin(), keys.end());
+
+                order_.resize(keys.size());
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    order_[i] = keys[i].second;
+                    if (i == 0 || keys[i].first != keys[i - 1].first)
+                        cells_[keys[i].first] = {i, i};
+                    cells_[keys[i].first].second = i + 1;
+                }
+            }
+
+            /**
+             * @brief Finds the k nearest neighbors of point i (excluding itself), nearest first.
+             *        Fewer neighbors are returned for isolated points, see maxRings.
+             */
+            void kNearest(size_t i, int k, Neighbors &out) const
+            {
+                out.clear();
+                const MR::Vector3f &p = points_[i];
+                const MR::Vector3i c = cellOf(p);
+                for (int r = 0; r <= maxRing_; ++r)
+                {
+                    for (int dx = -r; dx <= r; ++dx)
+                        for (int dy = -r; dy <= r; ++dy)
+                        {
+                            // only the shell of the ring, inner cells are visited already
+                            const bool side = std::abs(dx) == r || std::abs(dy) == r;
+                            for (int dz = -r; dz <= r; dz += side ? 1 : 2 * r)
+                            {
+                                auto it = cells_.find(cellKey({c.x + dx, c.y + dy, c.z + dz}));
+                                if (it == cells_.end())
+                                    continue;
+                                for (size_t j = it->second.first; j < it->second.second; ++j)
+                                    if (order_[j] != i)
+                                        out.emplace_back((points_[order_[j]] - p).lengthSq(), order_[j]);
+                            }
+                        }
+                    // points not visited yet are farther than r cells away
+                    if (int(out.size()) >= k)
+                    {
+                        std::nth_element(out.begin(), out.begin() + (k - 1), out.end());
+                        float covered = r * cellSize_;
+                        if (out[k - 1].first <= covered * covered)
+                            break;
+                    }
+                }
+                if (int(out.size()) > k)
+                {
+                    std::nth_element(out.begin(), out.begin() + (k - 1), out.end());
+                    out.resize(k);
+                }
+                std::sort(out.begin(), out.end());
+            }
+
+        private:
+            const std::vector<MR::Vector3f> &points_;
+            MR::Vector3f origin_;
+            float cellSize_ = 1.f;
+            int maxRing_ = 0;
+            std::vector<size_t> order_;
+            std::unordered_map<std::uint64_t, std::pair<size_t, size_t>> cells_;
+
+            MR::Vector3i cellOf(const MR::Vector3f &p) const
+            {
+                return {static_cast<int>(std::floor((p.x - origin_.x) / cellSize_)),
+                        static_cast<int>(std::floor((p.y - origin_.y) / cellSize_)),
+                        static_cast<int>(std::floor((p.z - origin_.z) / cellSize_))};
+            }
+        };
+    } // namespace
+
+    /**
+     * @brief Constructor for PointCloudPreprocessing class
+     *
+     * @param settings Which steps to run and their parameters.
+     */
+    PointCloudPreprocessing::PointCloudPreprocessing(const PointCloudSettings &settings)
+        : settings_(settings) {}
+
+    /**
+     * @brief Runs all enabled preprocessing steps on the cloud.
+     *
+     * Normals of the input are carried through every step; estimated normals replace them.
+     *
+     * @param cloud The input point cloud, invalid points are skipped.
+     * @return MR::PointCloud The preprocessed cloud.
+     */
+    MR::PointCloud PointCloudPreprocessing::run(const MR::PointCloud &cloud) const
+    {
+        const size_t count = cloud.points.size();
+        std::vector<char> valid(count);
+        tbb::parallel_for(Range(0, count), [&](const Range &range)
+                          {
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                                  valid[i] = cloud.validPoints.test(MR::VertId(i)); });
+        const std::vector<size_t> indices = keptIndices(valid);
+
+        Points current;
+        current.points.resize(indices.size());
+        if (cloud.normals.size() >= count)
+            current.normals.resize(indices.size());
+        tbb::parallel_for(Range(0, indices.size()), [&](const Range &range)
+                          {
+                              for (size_t j = range.begin(); j < range.end(); ++j)
+                              {
+                                  MR::VertId v(indices[j]);
+                                  current.points[j] = cloud.points[v];
+                                  if (!current.normals.empty())
+                                      current.normals[j] = cloud.normals[v];
+                              } });
+        std::cout << "Preprocessing " << current.points.size() << " points..." << std::endl;
+
+        if (settings_.pcaAlign && !current.points.empty())
+        {
+            MR::AffineXf3f xf = pcaAlignment(current.points);
+            tbb::parallel_for(Range(0, current.points.size()), [&](const Range &range)
+                              {
+                                  for (size_t i = range.begin(); i < range.end(); ++i)
+                                  {
+                                      current.points[i] = xf(current.points[i]);
+                                      if (!current.normals.empty())
+                                          current.normals[i] = xf.A * current.normals[i];
+                                  } });
+        }
+        if (settings_.crop != CropMode::None)
+        {
+            current = crop(current);
+            std::cout << "  cropped to " << current.points.size() << " points" << std::endl;
+        }
+        if (settings_.voxelSize > 0.f && !current.points.empty())
+        {
+            current = voxelDownsample(current);
+            std::cout << "  downsampled to " << current.points.size() << " points" << std::endl;
+        }
+        if (settings_.outlierNeighbors > 0 && int(current.points.size()) > settings_.outlierNeighbors)
+        {
+            current = removeOutliers(current);
+            std::cout << "  " << current.points.size() << " points left after outlier removal" << std::endl;
+        }
+        if (settings_.normalNeighbors > 0 && int(current.points.size()) > settings_.normalNeighbors)
+            current.normals = estimateNormals(current.points);
+
+        MR::PointCloud result;
+        result.points.resize(current.points.size());
+        result.normals.resize(current.normals.size());
+        result.validPoints.resize(current.points.size(), true);
+        tbb::parallel_for(Range(0, current.points.size()), [&](const Range &range)
+                          {
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                              {
+                                  MR::VertId v(i);
+                                  result.points[v] = current.points[i];
+                                  if (!current.normals.empty())
+                                      result.normals[v] = current.normals[i];
+                              } });
+        return result;
+    }
+
+    /**
+     * @brief Computes the rotation around the centroid which maps the principal axes onto x, y, z.
+     *
+     * The axis with the largest variance goes to x and the smallest to z, like the PCA in scripts/cut.py.
+     * The sign of every eigenvector is arbitrary, so unlike the script the directions are fixed:
+     * x and z point towards the longer tail of the cloud (positive third moment of the coordinates)
+     * and y completes a right-handed frame. The same scan is then always cut on the same side.
+     *
+     * @param points The points.
+     * @return MR::AffineXf3f The alignment transformation.
+     */
+    MR::AffineXf3f PointCloudPreprocessing::pcaAlignment(const std::vector<MR::Vector3f> &points) const
+    {
+        const MR::Vector3d center = centroid(points);
+        MR::SymMatrix3d cov = tbb::parallel_reduce(
+            Range(0, points.size()), MR::SymMatrix3d{},
+            [&](const Range &range, MR::SymMatrix3d acc)
+            {
+                for (size_t i = range.begin(); i < range.end(); ++i)
+                    addCovariance(acc, MR::Vector3d(points[i]) - center);
+                return acc;
+            },
+            [](MR::SymMatrix3d a, const MR::SymMatrix3d &b)
+            {
+                a += b;
+                return a;
+            });
+
+        // eigenvalues in ascending order, eigenvectors in the rows
+        MR::Matrix3d eigenvectors;
+        cov.eigens(&eigenvectors);
+        MR::Matrix3d rotation(eigenvectors.z, eigenvectors.y, eigenvectors.x);
+
+        MR::Vector3d thirdMoment = tbb::parallel_reduce(
+            Range(0, points.size()), MR::Vector3d{},
+            [&](const Range &range, MR::Vector3d acc)
+            {
+                for (size_t i = range.begin(); i < range.end(); ++i)
+                {
+                    MR::Vector3d d = rotation * (MR::Vector3d(points[i]) - center);
+                    acc += MR::Vector3d(d.x * d.x * d.x, d.y * d.y * d.y, d.z * d.z * d.z);
+                }
+                return acc;
+            },
+            [](const MR::Vector3d &a, const MR::Vector3d &b)
+            { return a + b; });
+        if (thirdMoment.x < 0)
+            rotation.x = -rotation.x;
+        if (thirdMoment.z < 0)
+            rotation.z = -rotation.z;
+        rotation.y = MR::cross(rotation.z, rotation.x);
+
+        MR::Matrix3f rotationf(MR::Vector3f(rotation.x), MR::Vector3f(rotation.y), MR::Vector3f(rotation.z));
+        return MR::AffineXf3f::xfAround(rotationf, MR::Vector3f(center));
+    }
+
+    /**
+     * @brief Removes the points outside of the crop plane or box.
+     *
+     * @param cloud The points with their attributes.
+     * @return Points The remaining points.
+     */
+    PointCloudPreprocessing::Points PointCloudPreprocessing::crop(const Points &cloud) const
+    {
+        const std::vector<MR::Vector3f> &points = cloud.points;
+        const MR::Vector3f normal = settings_.planeNormal.normalized();
+        float offset = settings_.planeOffset;
+        if (settings_.crop == CropMode::Plane && settings_.planeMidpointScale > 0.f)
+        {
+            using MinMax = std::pair<float, float>;
+            auto [lo, hi] = tbb::parallel_reduce(
+                Range(0, points.size()), MinMax{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()},
+                [&](const Range &range, MinMax acc)
+                {
+                    for (size_t i = range.begin(); i < range.end(); ++i)
+                    {
+                        float d = MR::dot(normal, points[i]);
+                        acc = {std::min(acc.first, d), std::max(acc.second, d)};
+                    }
+                    return acc;
+                },
+                [](const MinMax &a, const MinMax &b)
+                { return MinMax{std::min(a.first, b.first), std::max(a.second, b.second)}; });
+            offset = settings_.planeMidpointScale * (lo + hi) / 2.f;
+        }
+
+        std::vector<char> keep(points.size());
+        tbb::parallel_for(Range(0, points.size()), [&](const Range &range)
+                          {
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                              {
+                                  if (settings_.crop == CropMode::Plane)
+                                      keep[i] = MR::dot(normal, points[i]) <= offset;
+                                  else
+                                      keep[i] = settings_.cropBox.contains(points[i]);
+                              } });
+        const std::vector<size_t> indices = keptIndices(keep);
+        return {gather(cloud.points, indices), gather(cloud.normals, indices)};
+    }
+
+    /**
+     * @brief Replaces the points of every occupied voxel by their centroid.
+     *
+     * Normals of a voxel are averaged and normalized.
+     * Voxels are keyed by their full integer coordinates, so any cloud size works; a voxel size
+     * giving more than 2^30 voxels along an axis is raised to keep the coordinates in int range.
+     *
+     * @param cloud The points with their attributes.
+     * @return Points One point per occupied voxel.
+     */
+    PointCloudPreprocessing::Points PointCloudPreprocessing::voxelDownsample(const Points &cloud) const
+    {
+        const std::vector<MR::Vector3f> &points = cloud.points;
+        const MR::Box3f box = boundingBox(points);
+        const MR::Vector3f size = box.size();
+        const float maxSize = std::max({size.x, size.y, size.z});
+        float voxelSize = settings_.voxelSize;
+        if (maxSize / voxelSize > float(1 << 30))
+        {
+            voxelSize = maxSize / float(1 << 30);
+            std::cout << "  voxel size " << settings_.voxelSize << " is too small for the cloud, using " << voxelSize << std::endl;
+        }
+
+        using CellKey = std::array<int, 3>;
+        std::vector<std::pair<CellKey, size_t>> keys(points.size());
+        tbb::parallel_for(Range(0, points.size()), [&](const Range &range)
+                          {
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                              {
+                                  MR::Vector3f v = (points[i] - box.min) / voxelSize;
+                                  keys[i] = {CellKey{int(v.x), int(v.y), int(v.z)}, i};
+                              } });
+        tbb::parallel_sort(keys.begin(), keys.end());
+
+        // every run of equal keys is one voxel
+        std::vector<char> isStart(keys.size());
+        tbb::parallel_for(Range(0, keys.size()), [&](const Range &range)
+                          {
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                                  isStart[i] = i == 0 || keys[i].first != keys[i - 1].first; });
+        std::vector<size_t> starts = keptIndices(isStart);
+        starts.push_back(keys.size());
+
+        const size_t voxels = starts.size() - 1;
+        Points result;
+        result.points.resize(voxels);
+        if (!cloud.normals.empty())
+            result.normals.resize(voxels);
+        tbb::parallel_for(Range(0, voxels), [&](const Range &range)
+                          {
+                              for (size_t v = range.begin(); v < range.end(); ++v)
+                              {
+                                  const size_t count = starts[v + 1] - starts[v];
+                                  MR::Vector3d sum;
+                                  MR::Vector3f normalSum;
+                                  for (size_t i = starts[v]; i < starts[v + 1]; ++i)
+                                  {
+                                      const size_t p = keys[i].second;
+                                      sum += MR::Vector3d(points[p]);
+                                      if (!cloud.normals.empty())
+                                          normalSum += cloud.normals[p];
+                                  }
+                                  result.points[v] = MR::Vector3f(sum / double(count));
+                                  if (!cloud.normals.empty())
+                                  {
+                                      // opposite normals may cancel out, then keep the first one
+                                      result.normals[v] = normalSum.lengthSq() > 0.f ? normalSum.normalized()
+                                                                                     : cloud.normals[keys[starts[v]].second];
+                                  }
+                              } });
+        return result;
+    }
+
+    /**
+     * @brief Statistical outlier removal: drops points whose mean distance to their nearest
+     *        neighbors is larger than the global mean plus outlierStdRatio standard deviations.
+     *
+     * @param cloud The points with their attributes.
+     * @return Points The inlier points.
+     */
+    PointCloudPreprocessing::Points PointCloudPreprocessing::removeOutliers(const Points &cloud) const
+    {
+        const std::vector<MR::Vector3f> &points = cloud.points;
+        const int k = settings_.outlierNeighbors;
+        NeighborGrid grid(points, k);
+        tbb::enumerable_thread_specific<NeighborGrid::Neighbors> neighbors;
+
+        std::vector<float> meanDistances(points.size());
+        tbb::parallel_for(Range(0, points.size()), [&](const Range &range)
+                          {
+                              auto &local = neighbors.local();
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                              {
+                                  grid.kNearest(i, k, local);
+                                  double sum = 0.0;
+                                  for (const auto &[distSq, j] : local)
+                                      sum += std::sqrt(distSq);
+                                  // too few neighbors within the search radius means an isolated point
+                                  meanDistances[i] = int(local.size()) < k ? std::numeric_limits<float>::infinity()
+                                                                           : float(sum / local.size());
+                              } });
+
+        struct Moments
+        {
+            double sum = 0.0;
+            double sumSq = 0.0;
+            size_t count = 0;
+        };
+        Moments moments = tbb::parallel_reduce(
+            Range(0, points.size()), Moments{},
+            [&](const Range &range, Moments acc)
+            {
+                for (size_t i = range.begin(); i < range.end(); ++i)
+                {
+                    if (!std::isfinite(meanDistances[i]))
+                        continue;
+                    acc.sum += meanDistances[i];
+                    acc.sumSq += double(meanDistances[i]) * meanDistances[i];
+                    ++acc.count;
+                }
+                return acc;
+            },
+            [](const Moments &a, const Moments &b)
+            { return Moments{a.sum + b.sum, a.sumSq + b.sumSq, a.count + b.count}; });
+        if (moments.count == 0)
+            return {};
+        const double mean = moments.sum / moments.count;
+        const double stdDev = std::sqrt(std::max(0.0, moments.sumSq / moments.count - mean * mean));
+        const double threshold = mean + settings_.outlierStdRatio * stdDev;
+
+        std::vector<char> keep(points.size());
+        tbb::parallel_for(Range(0, points.size()), [&](const Range &range)
+                          {
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                                  keep[i] = meanDistances[i] <= threshold; });
+        const std::vector<size_t> indices = keptIndices(keep);
+        return {gather(cloud.points, indices), gather(cloud.normals, indices)};
+    }
+
+    /**
+     * @brief Estimates a normal per point as the smallest principal axis of its nearest neighbors.
+     *
+     * Normals are oriented away from the cloud centroid.
+     *
+     * @param points The points.
+     * @return std::vector<MR::Vector3f> Unit normal per point.
+     */
+    std::vector<MR::Vector3f> PointCloudPreprocessing::estimateNormals(const std::vector<MR::Vector3f> &points) const
+    {
+        const int k = settings_.normalNeighbors;
+        const MR::Vector3f center(centroid(points));
+        NeighborGrid grid(points, k);
+        tbb::enumerable_thread_specific<NeighborGrid::Neighbors> neighbors;
+
+        std::vector<MR::Vector3f> normals(points.size());
+        tbb::parallel_for(Range(0, points.size()), [&](const Range &range)
+                          {
+                              auto &local = neighbors.local();
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                              {
+                                  grid.kNearest(i, k, local);
+                                  MR::Vector3d mean(points[i]);
+                                  for (const auto &[distSq, j] : local)
+                                      mean += MR::Vector3d(points[j]);
+                                  mean = mean / double(local.size() + 1);
+
+                                  MR::SymMatrix3d cov;
+                                  addCovariance(cov, MR::Vector3d(points[i]) - mean);
+                                  for (const auto &[distSq, j] : local)
+                                      addCovariance(cov, MR::Vector3d(points[j]) - mean);
+
+                                  MR::Matrix3d eigenvectors;
+                                  cov.eigens(&eigenvectors);
+                                  MR::Vector3f n(eigenvectors.x);
+                                  if (MR::dot(n, points[i] - center) < 0.f)
+                                      n = -n;
+                                  normals[i] = n;
+                              } });
+        return normals;
+    }
+
+} // namespace DMD
@@ -0,0 +1,288 @@
+/**
+ * @file Stages.cpp
+ * @author DMD team, IU
+ * @brief Implementation of the mesh processing stages shared by all pipelines
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
+ *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ */
+
+#include "Stages.h"
+
+#include <atomic>
+#include <sstream>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace DMD::Stages
+{
+
+    /**
+     * @brief Loads a mesh from a given file path.
+     *
+     * @param path The file path to the STL mesh file.
+     * @return MR::Expected<MR::Mesh> The loaded mesh or an error if loading fails.
+     */
+    MR::Expected<MR::Mesh> loadMesh(const std::filesystem::path &path)
+    {
+        auto mesh = MR::MeshLoad::fromAnyStl(path);
+        if (!mesh)
+            return MR::unexpected("Error loading mesh from " + path.string() + ": " + mesh.error());
+        return mesh;
+    }
+
+    /**
+     * @brief Loads a point cloud from a given file path.
+     *
+     * @param path The file path to the point cloud (PCD, PLY, ...).
+     * @return MR::Expected<MR::PointCloud> The loaded cloud or an error if loading fails.
+     */
+    MR::Expected<MR::PointCloud> loadPoints(const std::filesystem::path &path)
+    {
+        auto cloud = MR::PointsLoad::fromAnySupportedFormat(path);
+        if (!cloud)
+            return MR::unexpected("Error loading points from " + path.string() + ": " + cloud.error());
+        return cloud;
+    }
+
+    /**
+     * @brief Fills holes in the given mesh.
+     *
+     * @param mesh Reference to the mesh in which holes will be filled.
+     */
+    void fillHoles(MR::Mesh &mesh)
+    {
+        // fillHoles is the adaptation from examples/fillHoles.cpp
+        auto holeEdges = mesh.topology.findHoleRepresentiveEdges();
+        for (MR::EdgeId e : holeEdges)
+        {
+            MR::FillHoleParams params;
+            params.metric = MR::getUniversalMetric(mesh);
+            MR::fillHole(mesh, e, params);
+        }
+    }
+
+    /**
+     * @brief Rebuilds the given mesh on a uniform voxel grid.
+     *
+     * @param mesh Reference to the mesh to be rebuilt.
+     * @param voxelSize The voxel size in mm.
+     * @return MR::Expected<MR::Mesh> The rebuilt mesh or an error if the process fails.
+     */
+    MR::Expected<MR::Mesh> reBuild(const MR::Mesh &mesh, float voxelSize)
+    {
+        // rebuildMesh params setting
+        MR::RebuildMeshSettings settings;
+        settings.decimate = false;
+        settings.voxelSize = voxelSize;
+        settings.progress = onProgress; // callback for progress
+
+        MR::MeshPart meshPart(mesh);
+        return MR::rebuildMesh(meshPart, settings);
+    }
+
+    /**
+     * @brief Rebuilds the given mesh from a sparse narrow band level set around its surface.
+     *
+     * Unlike reBuild, no dense grid over the bounding box is allocated. OpenVDB converts the mesh
+     * and extracts the surface block by block (8^3 leaf nodes) in parallel, and the extracted
+     * surface is closed. With adaptivity > 0 flat regions get larger triangles while curved
+     * regions keep the full voxel resolution.
+     *
+     * The level set sign is only correct for a closed input (fill holes first), and the output is
+     * checked for holes, so later stages (ICP, boolean) always get a watertight mesh.
+     *
+     * @param mesh Reference to the closed mesh to be rebuilt.
+     * @param settings Voxel size, band width and adaptivity.
+     * @return MR::Expected<MR::Mesh> The rebuilt mesh or an error if the input is not closed,
+     *         the output is not watertight or the process fails.
+     */
+    MR::Expected<MR::Mesh> reBuildNarrowBand(const MR::Mesh &mesh, const NarrowBandSettings &settings)
+    {
+        if (!mesh.topology.isClosed())
+            return MR::unexpected("the narrow band rebuild needs a closed mesh, fill the holes first");
+
+        const MR::Vector3f voxelSize = MR::Vector3f::diagonal(settings.voxelSize);
+        MR::FloatGrid grid = MR::meshToLevelSet(MR::MeshPart(mesh), MR::AffineXf3f(), voxelSize, settings.bandWidth, onProgress);
+        if (!grid)
+            return MR::unexpected("cannot convert the mesh to a narrow band level set");
+
+        MR::GridToMeshSettings gridSettings;
+        gridSettings.voxelSize = voxelSize;
+        gridSettings.isoValue = 0.f;
+        gridSettings.adaptivity = settings.adaptivity;
+        gridSettings.cb = onProgress;
+        auto result = MR::gridToMesh(std::move(grid), gridSettings);
+        if (!result)
+            return result;
+        // an adaptive surface may come out with holes where neighbouring blocks do not match
+        if (!result->topology.findHoleRepresentiveEdges().empty())
+            return MR::unexpected("the narrow band rebuild is not watertight, try a lower adaptivity");
+        return result;
+    }
+
+    /**
+     * @brief Computes the local ICP transformation aligning the defect mesh or scan to the ideal mesh.
+     *
+     * @param ideal_mesh Reference to the ideal (reference) mesh.
+     * @param defect The defect (floating) mesh or point cloud.
+     * @param settings ICP parameters relative to the ideal mesh diagonal.
+     * @return MR::AffineXf3f The transformation to apply to the defect mesh.
+     */
+    MR::AffineXf3f localICP(const MR::Mesh &ideal_mesh, const MR::MeshOrPoints &defect, const ICPSettings &settings)
+    {
+        // following ICP is adapted from examples/mesh_ICP.cpp
+        float diagonal = ideal_mesh.getBoundingBox().diagonal();
+        MR::ICPProperties icpParams;
+        icpParams.distThresholdSq = MR::sqr(diagonal * settings.distThresholdFactor); // Use points pairs with maximum distance specified
+        icpParams.exitVal = diagonal * settings.exitFactor;                         // Stop when distance reached
+        icpParams.iterLimit = settings.iterLimit;
+
+        MR::ICP icp(defect,
+                    MR::MeshOrPoints{MR::MeshPart{ideal_mesh}},
+                    MR::AffineXf3f(), MR::AffineXf3f(),
+                    diagonal * settings.samplingFactor); // To sample points from object
+        icp.setParams(icpParams);
+        return icp.calculateTransformation();
+    }
+
+    /**
+     * @brief Computes the global (multiway) ICP transformation aligning the defect mesh to the ideal mesh.
+     *
+     * @param ideal_mesh Reference to the ideal mesh, kept fixed.
+     * @param defect_mesh Reference to the defect mesh.
+     * @param settings ICP parameters relative to the ideal mesh diagonal.
+     * @return MR::AffineXf3f The transformation to apply to the defect mesh.
+     */
+    MR::AffineXf3f globalICP(const MR::Mesh &ideal_mesh, const MR::Mesh &defect_mesh, const ICPSettings &settings)
+    {
+        float diagonal = ideal_mesh.getBoundingBox().diagonal();
+        MR::MultiwayICPSamplingParameters samplingParameters;
+        samplingParameters.samplingVoxelSize = diagonal * settings.samplingFactor;
+        samplingParameters.cb = onProgress;
+
+        MR::ICPObjects objects;
+        objects.push_back(MR::MeshOrPointsXf(ideal_mesh));
+        objects.push_back(MR::MeshOrPointsXf(defect_mesh));
+
+        MR::MultiwayICP multiwayICP(objects, samplingParameters);
+
+        MR::ICPProperties icpParams;
+        icpParams.distThresholdSq = MR::sqr(diagonal * settings.distThresholdFactor); // Use points pairs with maximum distance specified
+        icpParams.exitVal = diagonal * settings.exitFactor;                         // Stop when distance reached
+        icpParams.iterLimit = settings.iterLimit;
+        multiwayICP.setParams(icpParams);
+
+        // the first object (ideal mesh) stays fixed, the last one is the defect mesh
+        return multiwayICP.calculateTransformationsFixFirst().back();
+    }
+
+    /**
+     * @brief Performs a boolean operation on two meshes.
+     *
+     * @param mesh_a Reference to the first mesh.
+     * @param mesh_b Reference to the second mesh.
+     * @param operation The boolean operation, e.g. DifferenceAB.
+     * @return MR::Expected<MR::Mesh> The result mesh or the boolean error string.
+     */
+    MR::Expected<MR::Mesh> booleanOperation(const MR::Mesh &mesh_a, const MR::Mesh &mesh_b, MR::BooleanOperation operation)
+    {
+        MR::BooleanResult result = MR::boolean(mesh_a, mesh_b, operation);
+        if (!result.valid())
+            return MR::unexpected(result.errorString);
+        return std::move(result.mesh);
+    }
+
+    /**
+     * @brief Transforms the points and normals of the cloud in parallel.
+     *
+     * @param cloud The point cloud to be transformed.
+     * @param xf The transformation.
+     */
+    void transformPoints(MR::PointCloud &cloud, const MR::AffineXf3f &xf)
+    {
+        const bool hasNormals = cloud.normals.size() >= cloud.points.size();
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, cloud.points.size()),
+                          [&](const tbb::blocked_range<size_t> &range)
+                          {
+                              for (size_t i = range.begin(); i < range.end(); ++i)
+                              {
+                                  MR::VertId v(i);
+                                  cloud.points[v] = xf(cloud.points[v]);
+                                  if (hasNormals)
+                                      cloud.normals[v] = (xf.A * cloud.normals[v]).normalized();
+                              }
+                          });
+        cloud.invalidateCaches();
+    }
+
+    /**
+     * @brief Saves the mesh to a specified file path.
+     *
+     * @param mesh The mesh to be saved.
+     * @param path The file path where the mesh will be saved.
+     * @return MR::Expected<void> An error if saving fails.
+     */
+    MR::Expected<void> saveMesh(const MR::Mesh &mesh, const std::filesystem::path &path)
+    {
+        auto res = MR::MeshSave::toAnySupportedFormat(mesh, path);
+        if (res)
+            std::cout << "Saved the mesh to " << path << std::endl;
+        return res;
+    }
+
+    /**
+     * @brief Saves the point cloud to a specified file path.
+     *
+     * @param cloud The point cloud to be saved.
+     * @param path The file path where the cloud will be saved.
+     * @return MR::Expected<void> An error if saving fails.
+     */
+    MR::Expected<void> savePoints(const MR::PointCloud &cloud, const std::filesystem::path &path)
+    {
+        auto res = MR::PointsSave::toAnySupportedFormat(cloud, path);
+        if (res)
+            std::cout << "Saved the points to " << path << std::endl;
+        return res;
+    }
+
+    /**
+     * @brief Formats the transformation for printing.
+     *
+     * @param transform The transformation.
+     * @return std::string Translation and rotation matrix as text.
+     */
+    std::string affineToString(const MR::AffineXf3f &transform)
+    {
+        std::ostringstream oss;
+        auto translation = transform.b;
+        auto rotation = transform.A;
+        oss << "Translation: (" << translation.x << ", "
+            << translation.y << ", "
+            << translation.z << "), "
+            << "Rotation: (" << rotation.x.x << ", " << rotation.x.y << ", " << rotation.x.z << ", "
+            << rotation.y.x << ", " << rotation.y.y << ", " << rotation.y.z << ", "
+            << rotation.z.x << ", " << rotation.z.y << ", " << rotation.z.z << ")";
+        return oss.str();
+    }
+
+    /**
+     * @brief Callback function to report progress during operations.
+     *
+     * @param v A float value representing the progress (0.0 to 1.0).
+     * @return true if the operation should continue, false otherwise.
+     */
+    bool onProgress(float v)
+    {
+        // atomic, because independent stages may report progress concurrently
+        static std::atomic<int> gProgress = -1;
+        int progress = static_cast<int>(10.f * v);
+        if (gProgress.exchange(progress) != progress)
+        {
+            std::cout << "\r" << std::flush << ((progress + 1) * 10) << "% completed.";
+        }
+        return true;
+    }
+
+} // namespace DMD::Stages
@@ -0,0 +1,199 @@
+/**
+ * @file batch.cpp
+ * @author DMD team, IU
+ * @brief Runs the pipeline on many parts in one process, several parts at a time, and reports throughput.
+ * @version 0.1
+ * @date 2026-10-19
+ * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
+ *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ *                oneTBB - one task arena per concurrent job.
+ * @notes: The jobs file has one part per line: <ideal.stl> <defect.stl> [output_dir], # starts a comment.
+ *         Without --config every part runs the default boolean pipeline of meshlib_main,
+ *         with --config the stage graph from the file, where $ideal, $defect and $out are defined.
+ *         Exits with -1 if any part fails.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "JobScheduler.h"
+#include "Pipeline.h"
+#include "PipelineConfig.h"
+
+struct Part
+{
+    std::filesystem::path ideal_path;
+    std::filesystem::path defect_path;
+    std::filesystem::path output_dir;
+};
+
+/**
+ * @brief Reads the parts from the jobs file.
+ *
+ * @param path The jobs file path.
+ * @param parts Receives the parts.
+ * @return true if the file was read, false otherwise.
+ */
+bool readParts(const std::filesystem::path &path, std::vector<Part> &parts)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::cerr << "Error opening jobs file " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream iss(DMD::PipelineConfig::stripComment(line));
+        std::vector<std::string> tokens;
+        std::string token;
+        while (iss >> std::quoted(token))
+            tokens.push_back(token);
+        if (tokens.empty())
+            continue;
+        if (tokens.size() < 2)
+        {
+            std::cerr << "Expected <ideal.stl> <defect.stl> [output_dir] in: " << line << std::endl;
+            return false;
+        }
+        Part part{tokens[0], tokens[1], tokens.size() > 2 ? tokens[2] : ""};
+        if (part.output_dir.empty())
+            part.output_dir = "../meshes/batch/part_" + std::to_string(parts.size());
+        parts.push_back(part);
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether every part of a batch succeeded.
+ *
+ * @param report The batch report.
+ * @return true if every job returned 0, false otherwise.
+ */
+bool allPartsPassed(const DMD::BatchReport &report)
+{
+    return std::all_of(report.results.begin(), report.results.end(),
+                       [](const DMD::JobResult &result)
+                       { return result.status == 0; });
+}
+
+/**
+ * @brief Makes a job running the pipeline on one part.
+ *
+ * @param part The part.
+ * @param config_path The stage graph config, empty for the default boolean pipeline.
+ * @return DMD::Job The job.
+ */
+DMD::Job makeJob(const Part &part, const std::filesystem::path &config_path)
+{
+    return DMD::Job{part.output_dir.filename().string(), [part, config_path]
+                    {
+                        std::error_code ec;
+                        std::filesystem::create_directories(part.output_dir, ec);
+                        if (ec)
+                        {
+                            std::cerr << "Cannot create " << part.output_dir << ": " << ec.message() << std::endl;
+                            return -1;
+                        }
+                        DMD::Pipeline pipeline;
+                        if (config_path.empty())
+                        {
+                            pipeline.addBooleanGraph(part.ideal_path, part.defect_path, part.output_dir);
+                        }
+                        else
+                        {
+                            DMD::PipelineConfig config(pipeline);
+                            config.define("ideal", part.ideal_path.string());
+                            config.define("defect", part.defect_path.string());
+                            config.define("out", part.output_dir.string());
+                            if (!config.parseFile(config_path))
+                                return -1;
+                        }
+                        return pipeline.run();
+                    }};
+}
+
+int main(int argc, char **argv)
+{
+    DMD::JobSchedulerSettings settings;
+    std::filesystem::path jobs_path;
+    std::filesystem::path config_path;
+    bool sweep = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--jobs" && i + 1 < argc)
+            settings.jobs = std::stoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc)
+            settings.threadsPerJob = std::stoi(argv[++i]);
+        else if (arg == "--pin")
+            settings.pinThreads = true;
+        else if (arg == "--numa")
+            settings.numaAware = true;
+        else if (arg == "--config" && i + 1 < argc)
+            config_path = argv[++i];
+        else if (arg == "--sweep")
+            sweep = true;
+        else
+            jobs_path = arg;
+    }
+
+    if (jobs_path.empty())
+    {
+        std::cout << "Usage: ./meshlib_batch <jobs.txt> [--jobs K] [--threads T] [--pin] [--numa] [--config <file>] [--sweep]" << std::endl;
+        std::cout << "  jobs.txt: one part per line: <ideal.stl> <defect.stl> [output_dir]" << std::endl;
+        std::cout << "  --sweep:  run the batch for K = 1, 2, 4, ... jobs with all cores split between them" << std::endl;
+        return -1;
+    }
+
+    if (settings.pinThreads && settings.numaAware)
+    {
+        // pinned core ranges would override the NUMA node affinity TBB gives the arena threads
+        std::cerr << "--pin and --numa can not be used together" << std::endl;
+        return -1;
+    }
+
+    std::vector<Part> parts;
+    if (!readParts(jobs_path, parts))
+        return -1;
+
+    std::vector<DMD::Job> jobs;
+    for (const auto &part : parts)
+        jobs.push_back(makeJob(part, config_path));
+
+    if (!sweep)
+    {
+        DMD::BatchReport report = DMD::JobScheduler(settings).run(jobs);
+        report.print(std::cout);
+        return allPartsPassed(report) ? 0 : -1;
+    }
+
+    // try every split of the cores between concurrent jobs and threads per job
+    const int cores = int(DMD::JobScheduler::availableCores().size());
+    std::vector<DMD::BatchReport> reports;
+    bool passed = true;
+    for (int k = 1; k <= cores; k *= 2)
+    {
+        settings.jobs = k;
+        settings.threadsPerJob = cores / k;
+        reports.push_back(DMD::JobScheduler(settings).run(jobs));
+        reports.back().print(std::cout);
+        passed = allPartsPassed(reports.back()) && passed;
+    }
+
+    std::cout << "\nJobs  Threads/job  Wall (s)  Parts/hour" << std::endl;
+    for (const auto &report : reports)
+    {
+        std::cout << std::setw(4) << report.jobs << std::setw(13) << report.threadsPerJob
+                  << std::setw(10) << std::fixed << std::setprecision(2) << report.wallSeconds
+                  << std::setw(12) << std::setprecision(1) << report.partsPerHour() << std::endl;
+    }
+
+    return passed ? 0 : -1;
+}
@@ -2,16 +2,20 @@
  * @file main.cpp
  * @author DMD team, IU
  * @brief Runs the pipeline for reading, filling holes, rebuilding, icp registration, boolean and saving the output mesh.
- * @version 0.1
+ * @version 0.2
  * @date 2024-11-09
  * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
  *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
  * @notes: This pipeline is using the ICP registration algorithm from MeshLib which is local registration based,
  *         but if we have the defective mesh too much disoriented from the ideal mesh, then we have to apply global registration first then apply local registration.
+ *         Any other combination of stages can be given with --config <file> and/or --stage "<line>", see README.md.
  */
 
 #include <memory>
+#include <string>
+#include <vector>
 #include "Pipeline.h"
+#include "PipelineConfig.h"
 
 int main(int argc, char **argv)
 {
@@ -20,21 +24,55 @@ int main(int argc, char **argv)
     std::filesystem::path ideal_path = "../meshes/cylinder_matrix_ideal.stl";   // ideal.stl
     std::filesystem::path defect_path = "../meshes/cylinder_matrix_defect.stl"; // defect.stl
 
-    if (argc > 2)
+    std::filesystem::path config_path;
+    std::vector<std::string> stage_lines;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
     {
-        ideal_path = argv[1];
-        defect_path = argv[2];
+        std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc)
+            config_path = argv[++i];
+        else if (arg == "--stage" && i + 1 < argc)
+            stage_lines.push_back(argv[++i]);
+        else
+            positional.push_back(arg);
+    }
+
+    if (positional.size() >= 2)
+    {
+        ideal_path = positional[0];
+        defect_path = positional[1];
         std::cout << "Using user given paths: " << ideal_path.string() << ", " << defect_path.string() << std::endl;
     }
     else
     {
-        std::cout << "Usage: ./meshlib_main <ideal.stl> <defect.stl>" << std::endl;
+        std::cout << "Usage: ./meshlib_main [<ideal.stl> <defect.stl>] [--config <file>] [--stage \"<stage line>\"]..." << std::endl;
         std::cout << "Using default paths: " << ideal_path.string() << ", " << defect_path.string() << std::endl;
     }
 
-    // run pipeline on ideal and defective meshes
     // use unique pointer to avoid memory leaks if any
-    std::unique_ptr<DMD::Pipeline> pipeline = std::make_unique<DMD::Pipeline>(ideal_path, defect_path);
+    std::unique_ptr<DMD::Pipeline> pipeline;
+    if (config_path.empty() && stage_lines.empty())
+    {
+        // run the default pipeline on ideal and defective meshes
+        pipeline = std::make_unique<DMD::Pipeline>(ideal_path, defect_path);
+    }
+    else
+    {
+        // build the stage graph from the config file and the command line, $ideal and $defect are the mesh paths
+        pipeline = std::make_unique<DMD::Pipeline>();
+        DMD::PipelineConfig config(*pipeline);
+        config.define("ideal", ideal_path.string());
+        config.define("defect", defect_path.string());
+        if (!config_path.empty() && !config.parseFile(config_path))
+            return -1;
+        for (size_t i = 0; i < stage_lines.size(); ++i)
+        {
+            if (!config.parseLine(stage_lines[i], int(i + 1)))
+                return -1;
+        }
+    }
+
     if (pipeline->run() == 0)
     {
         std::cout << "Pipline run success" << std::endl;
@@ -42,13 +80,8 @@ int main(int argc, char **argv)
     else
     {
         std::cout << "Failed to run the pipline" << std::endl;
+        return -1;
     }
 
-    /*
-    // run pipeline on ideal and defective meshes
-    DMD::Pipeline pipeline(ideal_path, defect_path);
-    pipeline.run();
-    */
-
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,186 @@
+/**
+ * @file rebuild_benchmark.cpp
+ * @author DMD team, IU
+ * @brief Compares time and memory of the dense rebuild and the narrow band rebuild on the given meshes.
+ * @version 0.2
+ * @date 2026-10-19
+ * @dependencies: MeshLib - An open-source 3D geometry library for processing, editing,
+ *                and manipulating 3D meshes. https://github.com/MeshInspector/MeshLib
+ * @notes: Every rebuild mode runs in its own child process (the benchmark re-executes itself with
+ *         --mode), so memory freed by one mode is never reused by the next and VmHWM of the child
+ *         is the absolute peak of that mode. Peak memory is read from /proc/self/status, so this
+ *         benchmark only runs on Linux.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Stages.h"
+
+// default sample meshes
+std::vector<std::filesystem::path> mesh_paths = {"../old_meshes/detal_ideal.stl",
+                                                 "../old_meshes/detal_defect.stl"};
+
+// rebuild modes, each measured in its own process
+const std::vector<std::string> modes = {"dense", "narrow_band", "adaptive"};
+
+/**
+ * @brief Reads a memory field (in kB) from /proc/self/status.
+ *
+ * @param field The field name, e.g. "VmHWM".
+ * @return long The value in kB, or -1 if not available.
+ */
+long readStatusKb(const std::string &field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.rfind(field + ":", 0) == 0)
+            return std::stol(line.substr(field.size() + 1));
+    }
+    return -1;
+}
+
+/**
+ * @brief Runs one rebuild mode on one mesh and prints time, absolute peak memory and the result size.
+ *
+ * Called in the child process started by runChild.
+ *
+ * @param mode The rebuild mode: dense, narrow_band or adaptive.
+ * @param path The mesh path.
+ * @param voxelSize The voxel size in mm.
+ * @return int 0 on success, -1 otherwise.
+ */
+int measure(const std::string &mode, const std::filesystem::path &path, float voxelSize)
+{
+    auto mesh = DMD::Stages::loadMesh(path);
+    if (!mesh)
+    {
+        std::cerr << mesh.error() << std::endl;
+        return -1;
+    }
+    DMD::Stages::fillHoles(*mesh);
+    long loadedPeak = readStatusKb("VmHWM");
+
+    DMD::NarrowBandSettings narrowBand;
+    narrowBand.voxelSize = voxelSize;
+    narrowBand.adaptivity = mode == "adaptive" ? 0.5f : 0.f;
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = mode == "dense" ? DMD::Stages::reBuild(*mesh, voxelSize)
+                                  : DMD::Stages::reBuildNarrowBand(*mesh, narrowBand);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    long peak = readStatusKb("VmHWM");
+
+    std::cout << "  " << std::left << std::setw(12) << mode << std::right << std::fixed << std::setprecision(2)
+              << std::setw(9) << elapsed.count() << " s";
+    if (peak >= 0 && loadedPeak >= 0)
+        std::cout << std::setw(10) << peak / 1024.0 << " MB peak (" << loadedPeak / 1024.0 << " MB after load)";
+    else
+        std::cout << "       n/a peak";
+    if (!result)
+    {
+        std::cout << "  failed: " << result.error() << std::endl;
+        return -1;
+    }
+    bool watertight = result->topology.findHoleRepresentiveEdges().empty();
+    std::cout << std::setw(10) << result->topology.numValidFaces() << " faces  "
+              << (watertight ? "watertight" : "HAS HOLES") << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Runs one rebuild mode in a fresh child process and waits for it.
+ *
+ * @param mode The rebuild mode.
+ * @param path The mesh path.
+ * @param voxelSize The voxel size in mm.
+ * @return int The exit code of the child, -1 if it could not be started.
+ */
+int runChild(const std::string &mode, const std::filesystem::path &path, float voxelSize)
+{
+    // the parent already runs TBB threads, so the child must not allocate before exec:
+    // everything it passes on is built here, at full float precision
+    std::ostringstream voxel;
+    voxel << std::setprecision(std::numeric_limits<float>::max_digits10) << voxelSize;
+    const std::string voxelArg = voxel.str();
+    const std::string pathArg = path.string();
+
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        std::cerr << "Cannot start the " << mode << " run: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    if (pid == 0)
+    {
+        // a new image, so nothing allocated by the parent or a previous mode is mapped
+        execl("/proc/self/exe", "meshlib_rebuild_benchmark", "--mode", mode.c_str(), pathArg.c_str(),
+              voxelArg.c_str(), static_cast<char *>(nullptr));
+        _exit(127);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 127)
+        std::cerr << "Cannot run /proc/self/exe for the " << mode << " run" << std::endl;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+int main(int argc, char **argv)
+{
+    float voxelSize = DMD::Stages::defaultVoxelSize;
+
+    // child: ./meshlib_rebuild_benchmark --mode <mode> <mesh.stl> <voxelSize>
+    if (argc == 5 && std::string(argv[1]) == "--mode")
+        return measure(argv[2], argv[3], std::stof(argv[4])) == 0 ? 0 : 1;
+
+    if (argc > 1)
+    {
+        mesh_paths.assign(argv + 1, argv + argc);
+        std::cout << "Using user given meshes" << std::endl;
+    }
+    else
+    {
+        std::cout << "Usage: ./meshlib_rebuild_benchmark <mesh.stl>..." << std::endl;
+        std::cout << "Using default sample meshes" << std::endl;
+    }
+
+    int failed = 0;
+    for (const auto &path : mesh_paths)
+    {
+        auto mesh = DMD::Stages::loadMesh(path);
+        if (!mesh)
+        {
+            std::cerr << mesh.error() << std::endl;
+            ++failed;
+            continue;
+        }
+
+        MR::Vector3f size = mesh->getBoundingBox().size();
+        double denseVoxels = std::ceil(size.x / voxelSize) * std::ceil(size.y / voxelSize) * std::ceil(size.z / voxelSize);
+        std::cout << "\n"
+                  << path.string() << ": " << mesh->topology.numValidFaces() << " faces, dense grid of "
+                  << denseVoxels / 1e6 << " M voxels (" << denseVoxels * sizeof(float) / (1024.0 * 1024.0)
+                  << " MB of floats) at " << voxelSize << " mm" << std::endl;
+
+        for (const auto &mode : modes)
+        {
+            if (runChild(mode, path, voxelSize) != 0)
+                ++failed;
+        }
+    }
+
+    return failed == 0 ? 0 : -1;
+}